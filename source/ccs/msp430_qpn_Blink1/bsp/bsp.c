@@ -1,5 +1,5 @@
 /*****************************************************************************
-* Product: BSP for the Simple Blinky example, MSP-EXP430G2, Vanilla kernel
+* Product: BSP for the Simple Blinky example, MSP-EXP430G2, Vanilla/QK kernel
 * Last updated for version 5.3.0
 * Last updated on  2014-04-18
 *
@@ -46,7 +46,43 @@
 #include <msp430g2553.h> /* MSP430 variant used on MSP-EXP430G2 LaunchPad */
 
 /*--------------------------------------------------------------------------*/
+#ifdef Q_SPY
+#define BSP_SMCLK   1000000UL   /* calibrated DCO for the UART, NOTE5 */
+#define BSP_QS_BAUD 9600UL
+#else
 #define BSP_SMCLK   1100000UL
+#endif
+#define BSP_ACLK    12000UL     /* VLO, +/- a lot, see the datasheet */
+
+#if BSP_TICKLESS
+#define BSP_TIMER_CLOCK  BSP_ACLK
+#else
+#define BSP_TIMER_CLOCK  BSP_SMCLK
+#endif
+
+/* Timer_A counts per tick, continuous mode, NOTE4 */
+#define BSP_TICK_COUNTS  ((BSP_TIMER_CLOCK + BSP_TICKS_PER_SEC/2) / BSP_TICKS_PER_SEC)
+#define BSP_TICK1_COUNTS ((BSP_TIMER_CLOCK + BSP_TICKS1_PER_SEC/2) / BSP_TICKS1_PER_SEC)
+
+static uint16_t BSP_timerRead(void);
+static void BSP_tick1Start(void);
+
+#ifdef Q_SPY
+static bool BSP_qsDrain(void);
+#endif
+
+#if BSP_TICKLESS
+#define BSP_TICK_MAX     (0xFFFFU / BSP_TICK_COUNTS)   /* longest period in ticks */
+
+static uint16_t l_tickStart  = 0U;  /* TAR at the start of the current period */
+static uint16_t l_tickPeriod = 1U;  /* ticks in the current timer period */
+static uint16_t l_tickDone   = 0U;  /* ticks of it already given to the AOs */
+
+static void BSP_tickAdvance(uint16_t ticks);
+static void BSP_tickSync(void);
+static void BSP_tickProgram(void);
+static bool BSP_tickIdle(void);
+#endif
 
 /* pin assignments to LEDs */
 #define LED1   (1U << 0)
@@ -60,19 +96,40 @@
 /*..........................................................................*/
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void timerA_ISR(void) {
+    QK_ISR_ENTRY();   /* inform QK-nano about ISR entry, NOTE2 */
 #ifdef NDEBUG
     __low_power_mode_off_on_exit(); /* disable low-power mode on exit, NOTE1*/
 #endif
+#if BSP_TICKLESS
+    BSP_tickAdvance(l_tickPeriod - l_tickDone); /* the rest of the period */
+    l_tickDone = 0U;
+    l_tickPeriod = 1U;  /* plain ticks until the next idle, NOTE3 */
+    l_tickStart = CCR0;
+    CCR0 = l_tickStart + BSP_TICK_COUNTS;
+#else
+    CCR0 += BSP_TICK_COUNTS;  /* next tick, continuous mode */
     QF_tickXISR(0U);  /* process all time events at clock tick rate 0 */
+#endif
 
-    //need to read up on this
-    //this might be related to using timer 0 timer 1, etc.
-    //ie, use 1u for timeout sig1
+    //tick rate 1 is on CCR1, see timerA1_ISR.  QF_tickXISR(1U)
+    //needs QF_MAX_TICK_RATE 2 in qpn_port.h, that's why it
+    //didn't work here.
 
-    //added to see if this is how you add time evets
-    //other than tick rate of 0, tick rate 1
- //   QF_tickXISR(1U);  /* process all time events at clock tick rate 0 */
-    //that didn't work
+    QK_ISR_EXIT();    /* run the AOs the tick made ready, NOTE2 */
+}
+/*..........................................................................*/
+#pragma vector = TIMER0_A1_VECTOR
+__interrupt void timerA1_ISR(void) {
+    QK_ISR_ENTRY();   /* inform QK-nano about ISR entry, NOTE2 */
+#ifdef NDEBUG
+    __low_power_mode_off_on_exit(); /* disable low-power mode on exit, NOTE1*/
+#endif
+    /* reading TAIV clears the flag */
+    if (TAIV == TA0IV_TACCR1) {
+        CCR1 += BSP_TICK1_COUNTS;  /* next tick, NOTE4 */
+        QF_tickXISR(1U);  /* process all time events at clock tick rate 1 */
+    }
+    QK_ISR_EXIT();    /* run the AOs the tick made ready, NOTE2 */
 }
 /*..........................................................................*/
 #pragma vector = NMI_VECTOR
@@ -83,18 +140,37 @@ __interrupt void nmi_ISR(void) {
 void BSP_init(void) {
     WDTCTL = (WDTPW | WDTHOLD); /* Stop WDT */
     P1DIR |= LED1 | LED2; /* configure LED1 and LED2 as outputs */
-    CCR0 = (BSP_SMCLK + BSP_TICKS_PER_SEC/2) / BSP_TICKS_PER_SEC;
-    TACTL = (TASSEL_2 | MC_1 | TACLR); /* SMCLK, upmode, clear timer */
+    CCR0 = BSP_TICK_COUNTS;
+#if BSP_TICKLESS
+    BCSCTL3 |= LFXT1S_2;  /* ACLK from the VLO, runs in LPM3 */
+    TACTL = (TASSEL_1 | MC_2 | TACLR); /* ACLK, continuous, clear timer */
+#else
+    TACTL = (TASSEL_2 | MC_2 | TACLR); /* SMCLK, continuous, clear timer */
+#endif
 
     //configure the button as input
 	P1DIR &=~ BIT3;
 	P1REN |= BIT3;		//pull up/down enabled
 	P1OUT |= BIT3;		//pull up
 
+#ifdef Q_SPY
+    //USCI_A0 is the trace UART, the lcd
+    //shares it so it isn't used, NOTE5
+    BCSCTL1 = CALBC1_1MHZ;
+    DCOCTL = CALDCO_1MHZ;
+
+    P1SEL |= BIT1 | BIT2;     //P1.1 RXD, P1.2 TXD
+    P1SEL2 |= BIT1 | BIT2;
+    UCA0CTL1 = UCSWRST | UCSSEL_2;  //reset, SMCLK
+    UCA0BR0 = (uint8_t)(BSP_SMCLK / BSP_QS_BAUD);
+    UCA0BR1 = (uint8_t)((BSP_SMCLK / BSP_QS_BAUD) >> 8);
+    UCA0MCTL = (uint8_t)((((BSP_SMCLK * 8UL) / BSP_QS_BAUD) & 7U) << 1); //UCBRSx
+    UCA0CTL1 &= ~UCSWRST;
+#else
 	//call functions to initialize the lcd
     SPIA_init();		//setup for SPI
     LCD_init();			//write ini commands
-
+#endif
 }
 /*..........................................................................*/
 void BSP_ledOff(void) {
@@ -110,18 +186,237 @@ void QF_onStartup(void) {
     CCTL0 = CCIE; /* CCR0 interrupt enabled */
 }
 /*..........................................................................*/
+#ifdef QK_PREEMPTIVE
+void QK_onIdle(void) {
+#if BSP_TICKLESS
+    uint_fast8_t p;
+#endif
+
+    QF_INT_DISABLE();
+#ifdef Q_SPY
+    if (BSP_qsDrain()) {  /* still sending the trace? */
+        QF_INT_ENABLE();
+        return;
+    }
+#endif
+    BSP_tick1Start();
+
+#if BSP_TICKLESS
+    if (!BSP_tickIdle()) {  /* the sync posted a timeout? */
+        p = QK_schedPrio_();
+        if (p != (uint_fast8_t)0) {
+            QK_sched_(p);
+        }
+        QF_INT_ENABLE();
+        return;
+    }
+#ifdef NDEBUG
+    __low_power_mode_3(); /* Enter LPM3, enables interrupts */
+#else
+    QF_INT_ENABLE();
+#endif
+
+#else
+#ifdef NDEBUG
+    /* every event was dispatched before the ISR returned, so
+    * it's safe to sleep here with interrupts enabled, NOTE2
+    */
+    __low_power_mode_1(); /* Enter LPM1, enables interrupts */
+#else
+    QF_INT_ENABLE();
+#endif
+#endif /* BSP_TICKLESS */
+}
+#else
+/*..........................................................................*/
 void QF_onIdle(void) {
 //      LED1_on();
 //      LED1_off();
 
+#ifdef Q_SPY
+    if (BSP_qsDrain()) {  /* still sending the trace? */
+        QF_INT_ENABLE();
+        return;
+    }
+#endif
+    BSP_tick1Start();
+
+#if BSP_TICKLESS
+    if (!BSP_tickIdle()) {  /* the sync posted a timeout? */
+        QF_INT_ENABLE();
+        return;
+    }
+#ifdef NDEBUG
+    __low_power_mode_3(); /* Enter LPM3, enables interrupts */
+#else
+    QF_INT_ENABLE();
+#endif
+
+#else
 #ifdef NDEBUG
     /* adjust the low-power mode to your application */
     __low_power_mode_1(); /* Enter LPM1 */
 #else
     QF_INT_ENABLE();
 #endif
+#endif /* BSP_TICKLESS */
+}
+#endif /* QK_PREEMPTIVE */
+/*..........................................................................*/
+//BSP_timerRead
+//TAR runs from ACLK in tickless mode, which isn't
+//synchronous to MCLK, so a read while it counts can
+//come back torn.  Read it until two reads agree.  With
+//SMCLK the first two always do.  Every TAR read goes
+//through here.
+static uint16_t BSP_timerRead(void) {
+    uint16_t t;
+
+    do {
+        t = TAR;
+    } while (t != TAR);
+    return t;
 }
 /*..........................................................................*/
+//BSP_tick1Start
+//Run the CCR1 tick only while a time event is armed
+//at rate 1, so AOs that don't use it cost nothing.
+//The first tick is one full period from now.  Call
+//with interrupts disabled.
+static void BSP_tick1Start(void) {
+    uint_fast8_t p;
+    bool armed = false;
+
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        if (QF_ROM_ACTIVE_GET_(p)->tickCtr[1] != (QTimeEvtCtr)0) {
+            armed = true;
+        }
+    }
+    if (armed) {
+        if ((CCTL1 & CCIE) == 0U) {
+            CCR1 = BSP_timerRead() + BSP_TICK1_COUNTS;
+            CCTL1 = CCIE;  /* CCR1 interrupt enabled */
+        }
+    }
+    else {
+        CCTL1 = 0U;  /* nothing armed, stop the rate 1 tick */
+    }
+}
+#if BSP_TICKLESS
+/*..........................................................................*/
+//BSP_tickAdvance
+//Give ticks to the armed time events at rate 0.  All
+//but the last are taken off directly, the period never
+//goes past the nearest expiry so none of them expire
+//early.  QF_tickXISR() does the last one and posts the
+//timeouts.  Call with interrupts disabled.
+static void BSP_tickAdvance(uint16_t ticks) {
+    uint_fast8_t p;
+    QActive *a;
+
+    if (ticks == 0U) {
+        return;
+    }
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        a = QF_ROM_ACTIVE_GET_(p);
+        if (a->tickCtr[0] != (QTimeEvtCtr)0) {
+            /* armed after the period started, NOTE3 */
+            if (a->tickCtr[0] < (QTimeEvtCtr)ticks) {
+                a->tickCtr[0] = (QTimeEvtCtr)1;
+            }
+            else {
+                a->tickCtr[0] -= (QTimeEvtCtr)(ticks - 1U);
+            }
+        }
+    }
+    QF_tickXISR(0U);
+}
+/*..........................................................................*/
+//BSP_tickSync
+//Bring the time events up to the whole ticks gone in
+//the current period, so the next expiry is from now.
+//Call with interrupts disabled and the CCR0 flag clear.
+static void BSP_tickSync(void) {
+    uint16_t elapsed = (uint16_t)(BSP_timerRead() - l_tickStart) / BSP_TICK_COUNTS;
+
+    if (elapsed > l_tickDone) {
+        BSP_tickAdvance(elapsed - l_tickDone);
+        l_tickDone = elapsed;
+    }
+}
+/*..........................................................................*/
+//BSP_tickProgram
+//End the period at the nearest armed time event, or
+//BSP_TICK_MAX if none are armed.  It's made longer
+//from where it is, so CCR0 stays ahead of TAR.  If
+//TAR got to it while this ran, set the flag so the
+//ISR doesn't wait for the timer to wrap.  Call with
+//interrupts disabled.
+static void BSP_tickProgram(void) {
+    uint_fast8_t p;
+    QActive *a;
+    uint16_t ticks = BSP_TICK_MAX - l_tickDone;
+
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        a = QF_ROM_ACTIVE_GET_(p);
+        if ((a->tickCtr[0] != (QTimeEvtCtr)0)
+            && (a->tickCtr[0] < (QTimeEvtCtr)ticks))
+        {
+            ticks = (uint16_t)a->tickCtr[0];
+        }
+    }
+    l_tickPeriod = l_tickDone + ticks;
+    CCR0 = l_tickStart + (l_tickPeriod * BSP_TICK_COUNTS);
+
+    if ((uint16_t)(BSP_timerRead() - l_tickStart) >= (uint16_t)(CCR0 - l_tickStart)) {
+        CCTL0 |= CCIFG;
+    }
+}
+/*..........................................................................*/
+//BSP_tickIdle
+//Sync and program the period before sleeping.  Returns
+//false if the sync posted a timeout and the AOs have to
+//run first.  If the period is already over, the ISR is
+//waiting and does it.  Call with interrupts disabled.
+static bool BSP_tickIdle(void) {
+    if ((CCTL0 & CCIFG) == 0U) {
+        BSP_tickSync();
+        if (QF_readySet_ != (uint_fast8_t)0) {
+            return false;
+        }
+        BSP_tickProgram();
+    }
+    return true;
+}
+#endif /* BSP_TICKLESS */
+/*..........................................................................*/
+#ifdef Q_SPY
+//BSP_qsDrain
+//Send the next trace byte if the UART can take it.
+//Returns true while there's more to send or the last
+//byte is still going out, the idle mustn't stop
+//SMCLK then.  Call with interrupts disabled.
+static bool BSP_qsDrain(void) {
+    uint16_t b;
+
+    if ((IFG2 & UCA0TXIFG) != 0U) {
+        b = QS_getByte();
+        if (b != QS_EOD) {
+            UCA0TXBUF = (uint8_t)b;
+            return true;
+        }
+    }
+    else {
+        return true;
+    }
+    return ((UCA0STAT & UCBUSY) != 0U);
+}
+/*..........................................................................*/
+uint16_t QS_onGetTime(void) {
+    return BSP_timerRead();
+}
+#endif /* Q_SPY */
+/*..........................................................................*/
 void Q_onAssert(char const Q_ROM * const file, int line) {
     (void)file;       /* avoid compiler warning */
     (void)line;       /* avoid compiler warning */
@@ -139,4 +434,48 @@ void Q_onAssert(char const Q_ROM * const file, int line) {
 * this from happening, the macro __low_power_mode_off_on_exit() clears
 * any low-power mode in the *stacked* CPU status register, so that the
 * low-power mode won't be restored upon the ISR exit.
+*
+* NOTE2:
+* With QK-nano, QK_ISR_EXIT() dispatches the events the ISR posted to AOs
+* above the one it interrupted, with interrupts enabled, before the RETI.
+* A long dispatch in a low priority AO (a full LCD_Clear) gets preempted
+* right there.  Since nothing is left waiting when the ISR returns, the
+* idle loop could go back to sleep, but the timer ISRs still clear the low
+* power bits (NOTE1) so QK_onIdle() runs after them.  The idle programs the
+* next tickless period (NOTE3), without it the CPU would wake every tick,
+* and stops the rate 1 tick once nothing is armed at rate 1 (NOTE4).
+* The stack has to hold one ISR frame plus one dispatch for each AO
+* priority that can nest.
+*
+* NOTE3:
+* With BSP_TICKLESS, the timer runs from the VLO so it keeps going in LPM3,
+* and the idle sets CCR0 to the nearest armed time event (rate 0) instead
+* of the next tick.  The ISR gives the whole period to the time events when
+* it ends and goes back to one tick periods until the next idle, so AOs
+* that arm time events while running always start from a tick boundary.
+* A time event armed after a wake from some other ISR in the middle of a
+* long period can fire early by the ticks slept before the wake.  Only the
+* timer ISR posts events in this project.  The VLO is 4-20 kHz, so the
+* tick is only as good as that; use LFXT1 with a crystal for real timing.
+*
+* NOTE4:
+* Timer_A runs in continuous mode so CCR0 and CCR1 can each keep their own
+* rate, each ISR moves its compare register ahead by one period.  Rate 0
+* (BSP_TICKS_PER_SEC) is the system tick on CCR0.  Rate 1 (BSP_TICKS1_PER_SEC)
+* is a fine tick on CCR1 for AOs that arm with QActive_armX(me, 1U, ticks)
+* and get Q_TIMEOUT1_SIG.  It only runs while something is armed at rate 1,
+* the idle starts and stops it, so the rest of the system stays on the slow
+* tick.  Rate 1 isn't tickless, it wakes the cpu every period while armed.
+*
+* NOTE5:
+* With Q_SPY defined (qpn_port.h) QP-nano writes a trace record for each
+* post, dispatch, transition and tick (qsn.h), timestamped with TAR, which
+* never stops in continuous mode.  The idle sends the records out USCI_A0
+* at 9600 8N1 on P1.2, the launchpad's application UART, and only sleeps
+* once the ring is empty and the last byte is out.  The LCD's SPI is on the
+* same USCI, so the LCD isn't started.  The DCO is loaded with the 1 MHz
+* calibration so the baud rate is right.  Decode with
+* source/host/qspy_nano/qspy_nano.py, its default --clock 1000000 is the
+* fixed tick (SMCLK), pass --clock 12000 with BSP_TICKLESS (VLO).  A record takes about 10 ms to send at 9600,
+* so a burst longer than QS_RING_LEN drops records; the host counts them.
 */
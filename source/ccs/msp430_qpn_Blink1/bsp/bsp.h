@@ -35,7 +35,18 @@
 #define bsp_h
 
 /* system clock ticks per second ...........................................*/
-#define BSP_TICKS_PER_SEC    20U
+#define BSP_TICKS_PER_SEC    20U    /* tick rate 0, CCR0 */
+#define BSP_TICKS1_PER_SEC   1000U  /* tick rate 1, CCR1, only while armed */
+
+/* tickless idle, NOTE3 in bsp.c ...........................................*/
+//Set BSP_TICKLESS to 1 to run the timer from ACLK (VLO)
+//and program CCR0 for the nearest armed time event, so
+//the idle sleeps in LPM3 instead of waking every tick.
+//The VLO is only good to a few kHz, so the tick is too.
+//0, the default, keeps the fixed tick from SMCLK.
+#ifndef BSP_TICKLESS
+#define BSP_TICKLESS         0
+#endif
 
 void BSP_init(void);
 void BSP_ledOff(void);
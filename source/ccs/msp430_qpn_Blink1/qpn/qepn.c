@@ -498,6 +498,9 @@ void QHsm_dispatch_(QHsm * const me) {
         QStateHandler path[QHSM_MAX_NEST_DEPTH_]; /* transition entry path */
         int_fast8_t ip; /* transition entry path index */
 
+        /* the AO is the one QF just dispatched, the host knows which */
+        QS_REC_CRIT_(QS_QEP_TRAN, 0U, Q_SIG(me), (uintptr_t)me->temp.fun);
+
         path[0] = me->temp.fun; /* save the target of the transition */
         path[1] = t;
         path[2] = s;
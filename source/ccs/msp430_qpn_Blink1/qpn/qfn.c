@@ -216,6 +216,8 @@ bool QActive_postX_(QActive * const me, uint_fast8_t margin, enum_t const sig)
         }
         --me->head;
         ++me->nUsed;
+        QF_STAT_POST_(me);
+        QS_REC_(QS_QF_POST, me->prio, sig, me->nUsed);
 
         /* is this the first event? */
         if (me->nUsed == (uint_fast8_t)1) {
@@ -239,6 +241,8 @@ bool QActive_postX_(QActive * const me, uint_fast8_t margin, enum_t const sig)
     else {
         /* can tolerate dropping evts? */
         Q_ASSERT_ID(310, margin != (uint_fast8_t)0);
+        QF_STAT_FAIL_(me);
+        QS_REC_(QS_QF_POST_FAIL, me->prio, sig, me->nUsed);
 
         margin = (uint_fast8_t)false; /* posting failed */
     }
@@ -310,6 +314,8 @@ bool QActive_postXISR_(QActive * const me, uint_fast8_t margin,
         }
         --me->head;
         ++me->nUsed;
+        QF_STAT_POST_(me);
+        QS_REC_(QS_QF_POST_ISR, me->prio, sig, me->nUsed);
         /* is this the first event? */
         if (me->nUsed == (uint_fast8_t)1) {
             /* set the bit */
@@ -320,6 +326,8 @@ bool QActive_postXISR_(QActive * const me, uint_fast8_t margin,
     else {
         /* can tolerate dropping evts? */
         Q_ASSERT_ID(410, margin != (uint_fast8_t)0);
+        QF_STAT_FAIL_(me);
+        QS_REC_(QS_QF_POST_FAIL, me->prio, sig, me->nUsed);
         margin = (uint_fast8_t)false; /* posting failed */
     }
 
@@ -362,6 +370,8 @@ bool QActive_postXISR_(QActive * const me, uint_fast8_t margin,
 */
 void QF_tickXISR(uint_fast8_t const tickRate) {
     uint_fast8_t p = (uint_fast8_t)QF_MAX_ACTIVE;
+
+    QS_REC_(QS_QF_TICK, 0U, 0U, tickRate);
     do {
         QActive *a = QF_ROM_ACTIVE_GET_(p);
         if (a->tickCtr[tickRate] != (QTimeEvtCtr)0) {
@@ -452,6 +462,43 @@ void QActive_disarmX(QActive * const me, uint_fast8_t const tickRate) {
 }
 #endif /* #if (QF_TIMEEVT_CTR_SIZE != 0) */
 
+#ifdef QF_ACTIVE_STAT
+/****************************************************************************/
+/**
+* \description
+* Copies the queue statistics of the active object, so they can be read
+* while the application runs. Use the \c maxUsed of each active object
+* from a long run with the worst case load to size its queue buffer in
+* QF_active[].
+*
+* \arguments
+* \arg[in]  \c me    pointer (see \ref derivation)
+* \arg[out] \c stat  where to copy the statistics
+*/
+void QActive_getStat(QActive const * const me, QActiveStat * const stat) {
+    QF_INT_DISABLE();
+    *stat = me->stat;
+    QF_INT_ENABLE();
+}
+
+/****************************************************************************/
+/**
+* \description
+* Clears the counters and starts the high-water mark over from the events
+* in the queue now, for example after the start-up burst.
+*
+* \arguments
+* \arg[in,out] \c me  pointer (see \ref derivation)
+*/
+void QActive_resetStat(QActive * const me) {
+    QF_INT_DISABLE();
+    me->stat.maxUsed = (uint8_t)me->nUsed;
+    me->stat.nFail = (uint8_t)0;
+    me->stat.nDispatch = (uint16_t)0;
+    QF_INT_ENABLE();
+}
+#endif /* QF_ACTIVE_STAT */
+
 
 /****************************************************************************/
 /****************************************************************************/
@@ -534,9 +581,12 @@ int_t QF_run(void) {
                 a->tail = Q_ROM_BYTE(acb->end);
             }
             --a->tail;
+            QF_STAT_DISPATCH_(a);
+            QS_REC_(QS_QF_DISPATCH, p, Q_SIG(a), a->nUsed);
             QF_INT_ENABLE();
 
             QMSM_DISPATCH(&a->super); /* dispatch to the SM */
+            QS_REC_CRIT_(QS_QF_DONE, p, 0U, 0U);
         }
         else {
             /* QF_onIdle() must be called with interrupts DISABLED because
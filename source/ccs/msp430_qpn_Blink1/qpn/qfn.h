@@ -91,6 +91,23 @@
     #error "QF_MAX_TICK_RATE exceeds the 4 limit"
 #endif
 
+#ifdef QF_ACTIVE_STAT
+
+/*! Queue statistics of an active object */
+/**
+* \description
+* Collected by QF-nano when #QF_ACTIVE_STAT is defined in qpn_port.h, and
+* read with QActive_getStat(). A queue buffer of \a maxUsed events
+* (the \c end in QF_active[]) would have held everything posted so far.
+*/
+typedef struct {
+    uint8_t  maxUsed;   /*!< most events ever in the queue */
+    uint8_t  nFail;     /*!< posts that failed on the margin, stops at 255 */
+    uint16_t nDispatch; /*!< events dispatched, wraps around */
+} QActiveStat;
+
+#endif /* QF_ACTIVE_STAT */
+
 /****************************************************************************/
 /*! Active Object struct */
 /**
@@ -135,6 +152,11 @@ typedef struct {
     */
     uint_fast8_t volatile nUsed;
 
+#ifdef QF_ACTIVE_STAT
+    /*! queue statistics, see QActive_getStat() */
+    QActiveStat stat;
+#endif
+
 } QActive;
 
 /*! Virtual table for the QActive class */
@@ -308,6 +330,16 @@ void QActive_ctor(QActive * const me, QStateHandler initial);
 
 #endif /* (QF_TIMEEVT_CTR_SIZE != 0) */
 
+#ifdef QF_ACTIVE_STAT
+
+    /*! copy the queue statistics of an active object */
+    void QActive_getStat(QActive const * const me, QActiveStat * const stat);
+
+    /*! start the queue statistics of an active object over */
+    void QActive_resetStat(QActive * const me);
+
+#endif /* QF_ACTIVE_STAT */
+
 /****************************************************************************/
 
 #ifndef Q_NMSM
@@ -431,6 +463,33 @@ extern uint_fast8_t volatile QF_readySet_;
 */
 #define QF_ACTIVE_CAST(a_)     ((QActive *)(a_))
 
+#ifdef QF_ACTIVE_STAT
+
+    /*! record the queue depth after a post, in a critical section */
+    #define QF_STAT_POST_(me_) do { \
+        if ((me_)->nUsed > (uint_fast8_t)(me_)->stat.maxUsed) { \
+            (me_)->stat.maxUsed = (uint8_t)(me_)->nUsed; \
+        } \
+    } while (0)
+
+    /*! count a failed post, in a critical section */
+    #define QF_STAT_FAIL_(me_) do { \
+        if ((me_)->stat.nFail != (uint8_t)0xFF) { \
+            ++(me_)->stat.nFail; \
+        } \
+    } while (0)
+
+    /*! count a dispatch, in a critical section */
+    #define QF_STAT_DISPATCH_(me_) (++(me_)->stat.nDispatch)
+
+#else
+
+    #define QF_STAT_POST_(me_)      ((void)0)
+    #define QF_STAT_FAIL_(me_)      ((void)0)
+    #define QF_STAT_DISPATCH_(me_)  ((void)0)
+
+#endif /* QF_ACTIVE_STAT */
+
 
 /****************************************************************************/
 /****************************************************************************/
@@ -0,0 +1,271 @@
+/**
+* \file
+* \brief QK-nano implementation.
+* \ingroup qkn
+* \cond
+******************************************************************************
+* Product: QK-nano
+* Last updated for version 5.3.0
+* Last updated on  2014-04-14
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, www.state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* \endcond
+*/
+#include "qpn_port.h" /* QP-nano port */
+
+#ifdef QK_PREEMPTIVE
+
+#ifndef qassert_h
+    #include "qassert.h" /* QP assertions */
+#endif /* qassert_h */
+
+Q_DEFINE_THIS_MODULE("qkn")
+
+/* Global-scope objects *****************************************************/
+/**
+* \description
+* The priority of the task currently running. Starts above all the active
+* objects, so that nothing gets dispatched before QF_run() is done with
+* the initial transitions. Zero is the priority of the idle loop.
+*/
+uint_fast8_t volatile QK_currPrio_ = (uint_fast8_t)(QF_MAX_ACTIVE + 1);
+
+#ifdef QF_ISR_NEST
+uint_fast8_t volatile QK_intNest_;
+#endif
+
+#ifndef QK_NO_MUTEX
+/*! the QK-nano mutex priority ceiling, 0 when no mutex is locked */
+static uint_fast8_t volatile l_ceilingPrio;
+#endif
+
+/* local objects ************************************************************/
+static uint8_t const Q_ROM l_invPow2Lkup[] = {
+    (uint8_t)0xFF,
+    (uint8_t)0xFE, (uint8_t)0xFD, (uint8_t)0xFB, (uint8_t)0xF7,
+    (uint8_t)0xEF, (uint8_t)0xDF, (uint8_t)0xBF, (uint8_t)0x7F
+};
+
+/****************************************************************************/
+/**
+* \description
+* QF_run() is typically called from your startup code after you initialize
+* the QF and start at least one active object with QActive_start().
+* This implementation of QF_run() is for the preemptive QK-nano kernel.
+* After the initial transitions, events already posted get dispatched
+* and QF_run() becomes the QK-nano idle loop.
+*
+* \returns QF_run() does not return in embedded applications.
+*/
+int_t QF_run(void) {
+    uint_fast8_t p;
+    QActive *a;
+
+    /* set priorities all registered active objects... */
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        a = QF_ROM_ACTIVE_GET_(p);
+
+        /* QF_active[p] must be initialized */
+        Q_ASSERT_ID(110, a != (QActive *)0);
+
+        a->prio = p; /* set the priority of the active object */
+    }
+
+    /* trigger initial transitions in all registered active objects... */
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        a = QF_ROM_ACTIVE_GET_(p);
+        QMSM_INIT(&a->super); /* take the initial transition in the SM */
+    }
+
+    /* process any events posted during the initial transitions */
+    QF_INT_DISABLE();
+    QK_currPrio_ = (uint_fast8_t)0; /* priority of the QK idle loop */
+    p = QK_schedPrio_();
+    if (p != (uint_fast8_t)0) {
+        QK_sched_(p);
+    }
+    QF_INT_ENABLE();
+
+    QF_onStartup(); /* invoke startup callback */
+
+    /* the QK idle loop... */
+    for (;;) {
+        QK_onIdle(); /* invoke the on-idle callback */
+    }
+#ifdef __GNUC__  /* GNU compiler? */
+    return (int_t)0;
+#endif
+}
+
+/****************************************************************************/
+/**
+* \description
+* Finds the highest-priority active object with events, using the same
+* log2 lookup as the vanilla kernel.
+*
+* \returns the priority of that active object if it's above the current
+* priority and the mutex ceiling, zero otherwise.
+*
+* \note Must be called with interrupts disabled.
+*/
+uint_fast8_t QK_schedPrio_(void) {
+    uint_fast8_t p;
+
+#ifdef QF_LOG2
+    p = QF_LOG2(QF_readySet_);
+#else
+
+#if (QF_MAX_ACTIVE > 4)
+    /* hi nibble non-zero? */
+    if ((QF_readySet_ & (uint_fast8_t)0xF0) != (uint_fast8_t)0) {
+        p = (uint_fast8_t)(Q_ROM_BYTE(QF_log2Lkup[QF_readySet_ >> 4])
+                      + (uint_fast8_t)4);
+    }
+    /* hi nibble of QF_readySet_ is zero */
+    else
+#endif
+    {
+        p = Q_ROM_BYTE(QF_log2Lkup[QF_readySet_]);
+    }
+#endif
+
+    /* not above the current priority? */
+    if (p <= QK_currPrio_) {
+        p = (uint_fast8_t)0;
+    }
+#ifndef QK_NO_MUTEX
+    /* not above the mutex ceiling? */
+    else if (p <= l_ceilingPrio) {
+        p = (uint_fast8_t)0;
+    }
+#endif
+
+    return p;
+}
+
+/****************************************************************************/
+/**
+* \description
+* Dispatches one event at a time to the highest-priority ready active
+* object, until none are left above the priority that was running when
+* QK_sched_() was called. Each dispatch runs to completion with
+* interrupts enabled, and can be preempted by higher priorities.
+*
+* \arguments
+* \arg[in] \c p  priority of the first active object to run, from
+*                QK_schedPrio_().
+*
+* \note Must be called with interrupts disabled, and returns with
+* interrupts disabled.
+*/
+void QK_sched_(uint_fast8_t p) {
+    uint_fast8_t pin = QK_currPrio_; /* save the initial priority */
+    QActive *a;
+    QActiveCB const Q_ROM *acb;
+
+    do {
+        acb = &QF_active[p];
+        a = QF_ROM_ACTIVE_GET_(p);
+        QK_currPrio_ = p; /* this becomes the current task priority */
+
+        /* some unsuded events must be available */
+        Q_ASSERT_ID(210, a->nUsed > (uint_fast8_t)0);
+
+        --a->nUsed;
+        /* queue becoming empty? */
+        if (a->nUsed == (uint_fast8_t)0) {
+            QF_readySet_ &= Q_ROM_BYTE(l_invPow2Lkup[p]); /* clear bit */
+        }
+        Q_SIG(a) = QF_ROM_QUEUE_AT_(acb, a->tail).sig;
+#if (Q_PARAM_SIZE != 0)
+        Q_PAR(a) = QF_ROM_QUEUE_AT_(acb, a->tail).par;
+#endif
+        if (a->tail == (uint_fast8_t)0) { /* wrap around? */
+            a->tail = Q_ROM_BYTE(acb->end);
+        }
+        --a->tail;
+        QF_STAT_DISPATCH_(a);
+        QS_REC_(QS_QF_DISPATCH, p, Q_SIG(a), a->nUsed);
+        QF_INT_ENABLE(); /* unconditionally enable interrupts */
+
+        QMSM_DISPATCH(&a->super); /* dispatch to the SM */
+
+        QF_INT_DISABLE();
+        QS_REC_(QS_QF_DONE, p, 0U, 0U);
+        QK_currPrio_ = pin; /* restore the initial priority */
+        p = QK_schedPrio_(); /* anything else ready above it? */
+    } while (p != (uint_fast8_t)0);
+}
+
+#ifndef QK_NO_MUTEX
+/****************************************************************************/
+/**
+* \description
+* Locks the priority-ceiling mutex, so active objects at or below
+* \a prioCeiling can't preempt the caller until QK_mutexUnlock().
+* Use it around a resource shared by active objects, such as the SPI bus.
+*
+* \returns the previous ceiling, pass it to QK_mutexUnlock().
+*/
+QMutex QK_mutexLock(uint_fast8_t const prioCeiling) {
+    uint_fast8_t mutex;
+
+    QF_INT_DISABLE();
+    mutex = l_ceilingPrio; /* original QK-nano priority ceiling to return */
+    if (l_ceilingPrio < prioCeiling) {
+        l_ceilingPrio = prioCeiling; /* raise the QK-nano priority ceiling */
+    }
+    QF_INT_ENABLE();
+
+    return mutex;
+}
+
+/****************************************************************************/
+/**
+* \description
+* Puts the ceiling back to what it was before QK_mutexLock(), and runs
+* any active object that got ready above the caller while it was locked.
+*/
+void QK_mutexUnlock(QMutex mutex) {
+    uint_fast8_t p;
+
+    QF_INT_DISABLE();
+    if (l_ceilingPrio > mutex) {
+        l_ceilingPrio = mutex; /* restore the saved priority ceiling */
+        p = QK_schedPrio_();
+        if (p != (uint_fast8_t)0) {
+            QK_sched_(p);
+        }
+    }
+    QF_INT_ENABLE();
+}
+#endif /* QK_NO_MUTEX */
+
+#endif /* QK_PREEMPTIVE */
@@ -0,0 +1,122 @@
+/**
+* \file
+* \brief Public QK-nano interface.
+* \ingroup qkn
+* \cond
+******************************************************************************
+* Product: QK-nano
+* Last updated for version 5.3.0
+* Last updated on  2014-04-14
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, www.state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* \endcond
+*/
+#ifndef qkn_h
+#define qkn_h
+
+/**
+* \description
+* This header file must be included in all modules that use QP-nano with
+* the preemptive QK-nano kernel. Typically, this header file is included
+* indirectly through the header file qpn_port.h, when the macro
+* #QK_PREEMPTIVE is defined.
+*
+* QK-nano is a single-stack, run-to-completion preemptive kernel. An active
+* object runs as a one-shot task called from the ISR that made it ready,
+* or from QActive_postX_() when a task posts to a higher-priority active
+* object. Every ISR that posts events must call QK_ISR_ENTRY() on entry
+* and QK_ISR_EXIT() on exit.
+*/
+
+/****************************************************************************/
+/*! QK-nano idle callback */
+/**
+* \description
+* QK_onIdle() is called continuously from the QK-nano idle loop. This
+* callback gives the application an opportunity to enter a power-saving
+* CPU mode, or perform some other idle processing.
+*
+* \note QK_onIdle() is invoked with interrupts enabled and must also
+* return with interrupts enabled. Unlike the vanilla kernel, no events
+* can be waiting when QK_onIdle() runs, because all events posted from
+* ISRs are processed in QK_ISR_EXIT() before the ISR returns.
+*/
+void QK_onIdle(void);
+
+/*! the current QK-nano priority */
+extern uint_fast8_t volatile QK_currPrio_;
+
+#ifdef QF_ISR_NEST
+    /*! the interrupt nesting level of QK-nano */
+    extern uint_fast8_t volatile QK_intNest_;
+#endif
+
+/*! QK-nano scheduler, finds the highest-priority task ready to run */
+/**
+* \description
+* Returns the priority of the highest-priority active object ready to run
+* if it's above the current priority (and the mutex ceiling), or zero if
+* no preemption is needed.
+*
+* \note Must be called with interrupts disabled.
+*/
+uint_fast8_t QK_schedPrio_(void);
+
+/*! QK-nano scheduler, runs the ready tasks above the current priority */
+/**
+* \description
+* Dispatches events to all active objects above the current priority,
+* starting at \a p, with interrupts enabled during each dispatch.
+*
+* \note Must be called with interrupts disabled, and returns with
+* interrupts disabled.
+*/
+void QK_sched_(uint_fast8_t p);
+
+#ifndef QK_NO_MUTEX
+
+    /*! QK-nano priority-ceiling mutex */
+    typedef uint_fast8_t QMutex;
+
+    /*! QK-nano priority-ceiling mutex lock */
+    /**
+    * \description
+    * Raises the QK-nano priority ceiling to \a prioCeiling, so that active
+    * objects at or below the ceiling can't preempt the caller. Returns the
+    * previous ceiling, to be passed to QK_mutexUnlock().
+    */
+    QMutex QK_mutexLock(uint_fast8_t const prioCeiling);
+
+    /*! QK-nano priority-ceiling mutex unlock */
+    void QK_mutexUnlock(QMutex mutex);
+
+#endif /* QK_NO_MUTEX */
+
+#endif /* qkn_h */
@@ -1,5 +1,5 @@
 /*****************************************************************************
-* Product: Simple Blinky example, Vanilla kernel
+* Product: Simple Blinky example, Vanilla or QK-nano kernel
 * Last updated for version 5.3.0
 * Last updated on  2014-04-14
 *
@@ -44,6 +44,7 @@
 //used for passing data
 #define Q_PARAM_SIZE            4		//sizenumber of params for all events - 2 bytes
 #define QF_TIMEEVT_CTR_SIZE     2		//0, 1, 2, 4; 0 = no time events
+#define QF_MAX_TICK_RATE        2		//rate 0 on CCR0, rate 1 on CCR1, see bsp.c
 
 /* maximum # active objects--must match EXACTLY the QF_active[] definition */
 #define QF_MAX_ACTIVE           2		//blinky and the button
@@ -55,12 +56,49 @@
 /* interrupt disabling policy for interrupt level */
 /* #define QF_ISR_NEST */ /* nesting of ISRs not allowed */
 
+//kernel.  With QK_PREEMPTIVE defined, a higher priority AO
+//preempts a long dispatch in a lower one (QK-nano, qkn.c).
+//Comment it out for the cooperative vanilla loop in qfn.c,
+//where each dispatch runs to completion before the next AO.
+#define QK_PREEMPTIVE
+
+//ISRs that post events (the timer through QF_tickXISR) call
+//QK_ISR_ENTRY() first and QK_ISR_EXIT() last.  The exit runs
+//any AO the ISR made ready, above the one it interrupted,
+//before the ISR returns.  Nothing to do for the vanilla loop.
+#ifdef QK_PREEMPTIVE
+#define QK_ISR_ENTRY()          ((void)0)
+#define QK_ISR_EXIT()           do { \
+    uint_fast8_t p_ = QK_schedPrio_(); \
+    if (p_ != (uint_fast8_t)0) { \
+        QK_sched_(p_); \
+    } \
+} while (0)
+#else
+#define QK_ISR_ENTRY()          ((void)0)
+#define QK_ISR_EXIT()           ((void)0)
+#endif
+
+//software tracing (QS-nano, qsn.c).  Define Q_SPY to trace
+//posts, dispatches, transitions and ticks out the UART, see
+//NOTE5 in bsp.c.  USCI_A0 becomes the UART, so the lcd is off.
+/* #define Q_SPY */
+
+//queue statistics.  Define QF_ACTIVE_STAT to keep the most
+//events each AO queue held, failed posts and dispatches, read
+//with QActive_getStat(), to size the queues in main.c.
+/* #define QF_ACTIVE_STAT */
+
 #include <intrinsics.h> /* contains prototypes for the intrinsic functions */
 #include <stdint.h>     /* Exact-width types. WG14/N843 C99 Standard */
 #include <stdbool.h>    /* Boolean type.      WG14/N843 C99 Standard */
 
 #include "qepn.h"       /* QEP-nano platform-independent public interface */
 #include "qfn.h"        /* QF-nano platform-independent public interface */
+#include "qsn.h"        /* QS-nano software tracing interface */
+#ifdef QK_PREEMPTIVE
+#include "qkn.h"        /* QK-nano platform-independent public interface */
+#endif
 #include "qassert.h"    /* QP-nano assertions header file */
 
 #endif /* qpn_port_h */
@@ -0,0 +1,141 @@
+/**
+* \file
+* \brief QS-nano implementation, the trace ring buffer.
+* \ingroup qsn
+* \cond
+******************************************************************************
+* Product: QS-nano
+* Last updated for version 5.3.0
+* Last updated on  2014-04-14
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, www.state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* \endcond
+*/
+#include "qpn_port.h" /* QP-nano port */
+
+#ifdef Q_SPY
+
+#define QS_REC_SIZE  8U             /* bytes in a record, see qsn.h */
+#define QS_FRAME     ((uint8_t)0x7E) /* frame flag */
+#define QS_ESC       ((uint8_t)0x7D) /* escape byte */
+#define QS_ESC_XOR   ((uint8_t)0x20) /* XOR for the escaped byte */
+
+/* local objects ************************************************************/
+static uint8_t l_ring[QS_RING_LEN][QS_REC_SIZE];
+static uint_fast8_t l_head;  /* next record to write */
+static uint_fast8_t l_tail;  /* record being sent */
+static uint_fast8_t l_used;  /* records in the ring */
+static uint8_t l_seq;        /* sequence number of the next record */
+
+static uint_fast8_t l_pos;   /* next byte of the tail record to send */
+static uint8_t l_chk;        /* checksum of the tail record so far */
+static uint8_t l_esc;        /* second byte of an escape, 0 for none */
+
+/****************************************************************************/
+/**
+* \description
+* Copies the record into the ring buffer with the current timestamp. The
+* record is kept there until QS_getByte() has sent the whole frame, so
+* the UART never reads a slot that's being written.
+*/
+void QS_rec_(uint_fast8_t type, uint_fast8_t prio, uint_fast8_t sig,
+             uint16_t data)
+{
+    uint8_t *rec;
+    uint16_t time;
+
+    if (l_used < (uint_fast8_t)QS_RING_LEN) {
+        time = QS_onGetTime();
+        rec = &l_ring[l_head][0];
+        rec[0] = l_seq;
+        rec[1] = (uint8_t)type;
+        rec[2] = (uint8_t)prio;
+        rec[3] = (uint8_t)sig;
+        rec[4] = (uint8_t)data;
+        rec[5] = (uint8_t)(data >> 8);
+        rec[6] = (uint8_t)time;
+        rec[7] = (uint8_t)(time >> 8);
+
+        ++l_head;
+        if (l_head == (uint_fast8_t)QS_RING_LEN) {
+            l_head = (uint_fast8_t)0;
+        }
+        ++l_used;
+    }
+    ++l_seq; /* a dropped record still uses a number */
+}
+
+/****************************************************************************/
+/**
+* \description
+* Encodes the oldest record one byte per call: the record, its checksum,
+* then the flag, which frees the record.
+*
+* \returns the next byte to send, or #QS_EOD when the ring is empty.
+*/
+uint16_t QS_getByte(void) {
+    uint8_t b;
+
+    if (l_esc != (uint8_t)0) { /* second half of an escape? */
+        b = l_esc;
+        l_esc = (uint8_t)0;
+        return (uint16_t)b;
+    }
+    if (l_used == (uint_fast8_t)0) {
+        return QS_EOD;
+    }
+
+    if (l_pos < (uint_fast8_t)QS_REC_SIZE) {
+        b = l_ring[l_tail][l_pos];
+        l_chk += b;
+    }
+    else if (l_pos == (uint_fast8_t)QS_REC_SIZE) {
+        b = (uint8_t)~l_chk;
+    }
+    else { /* end of the frame, free the record */
+        l_pos = (uint_fast8_t)0;
+        l_chk = (uint8_t)0;
+        ++l_tail;
+        if (l_tail == (uint_fast8_t)QS_RING_LEN) {
+            l_tail = (uint_fast8_t)0;
+        }
+        --l_used;
+        return (uint16_t)QS_FRAME;
+    }
+    ++l_pos;
+
+    if ((b == QS_FRAME) || (b == QS_ESC)) {
+        l_esc = (uint8_t)(b ^ QS_ESC_XOR);
+        b = QS_ESC;
+    }
+    return (uint16_t)b;
+}
+
+#endif /* Q_SPY */
@@ -0,0 +1,125 @@
+/**
+* \file
+* \brief Public QS-nano interface, software tracing for QP-nano.
+* \ingroup qsn
+* \cond
+******************************************************************************
+* Product: QS-nano
+* Last updated for version 5.3.0
+* Last updated on  2014-04-14
+*
+*                    Q u a n t u m     L e a P s
+*                    ---------------------------
+*                    innovating embedded systems
+*
+* Copyright (C) Quantum Leaps, www.state-machine.com.
+*
+* This program is open source software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published
+* by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Alternatively, this program may be distributed and modified under the
+* terms of Quantum Leaps commercial licenses, which expressly supersede
+* the GNU General Public License and are specifically designed for
+* licensees interested in retaining the proprietary status of their code.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contact information:
+* Web:   www.state-machine.com
+* Email: info@state-machine.com
+******************************************************************************
+* \endcond
+*/
+#ifndef qsn_h
+#define qsn_h
+
+/**
+* \description
+* This header file is included in all QP-nano modules through qpn_port.h.
+* When the macro #Q_SPY is defined, QEP-nano, QF-nano and QK-nano write a
+* small binary record for each post, dispatch, transition and tick into a
+* RAM ring buffer. The BSP drains it from the idle loop with QS_getByte(),
+* and source/host/qspy_nano/qspy_nano.py decodes it on the host.
+* Without #Q_SPY all the trace macros expand to nothing.
+*
+* Each record is 8 bytes: sequence number, record type, AO priority,
+* signal, 16-bit data and 16-bit timestamp from QS_onGetTime(), both
+* little endian. On the wire a record is followed by its checksum (the
+* complement of the byte sum) and the 0x7E flag, with 0x7E and 0x7D inside
+* the frame sent as 0x7D followed by the byte XOR 0x20.
+*/
+
+/*! QS-nano record types, keep in sync with qspy_nano.py */
+enum QSpyRecords {
+    QS_QF_POST = 1,  /*!< posted from a task: prio, sig, queue depth */
+    QS_QF_POST_ISR,  /*!< posted from an ISR: prio, sig, queue depth */
+    QS_QF_POST_FAIL, /*!< post failed on margin: prio, sig, queue depth */
+    QS_QF_TICK,      /*!< QF_tickXISR(): tick rate */
+    QS_QF_DISPATCH,  /*!< event taken from the queue: prio, sig, depth left */
+    QS_QF_DONE,      /*!< run to completion step finished: prio */
+    QS_QEP_TRAN      /*!< transition taken: sig, target state address */
+};
+
+#ifdef Q_SPY
+
+/*! number of records the ring buffer holds, 8 bytes each */
+#ifndef QS_RING_LEN
+    #define QS_RING_LEN  8U
+#endif
+
+/*! returned by QS_getByte() when there is nothing to send */
+#define QS_EOD  ((uint16_t)0xFFFF)
+
+/*! write one trace record into the ring buffer */
+/**
+* \description
+* If the ring buffer is full the record is dropped, but its sequence number
+* is still used, so the host sees the gap.
+*
+* \note Must be called with interrupts disabled.
+*/
+void QS_rec_(uint_fast8_t type, uint_fast8_t prio, uint_fast8_t sig,
+             uint16_t data);
+
+/*! next byte of the trace stream for the UART, or QS_EOD */
+/**
+* \note Must be called with interrupts disabled.
+*/
+uint16_t QS_getByte(void);
+
+/*! QS-nano timestamp callback, implemented in the BSP */
+/**
+* \description
+* Returns a free-running 16-bit timer. The host unwraps it, so some record
+* has to be written at least once per timer wrap (the tick does that).
+*/
+uint16_t QS_onGetTime(void);
+
+/*! trace record, inside a critical section or an ISR */
+#define QS_REC_(type_, prio_, sig_, data_) \
+    QS_rec_((uint_fast8_t)(type_), (uint_fast8_t)(prio_), \
+            (uint_fast8_t)(sig_), (uint16_t)(data_))
+
+/*! trace record, from a task with interrupts enabled */
+#define QS_REC_CRIT_(type_, prio_, sig_, data_) do { \
+    QF_INT_DISABLE(); \
+    QS_REC_((type_), (prio_), (sig_), (data_)); \
+    QF_INT_ENABLE(); \
+} while (0)
+
+#else /* Q_SPY not defined */
+
+#define QS_REC_(type_, prio_, sig_, data_)       ((void)0)
+#define QS_REC_CRIT_(type_, prio_, sig_, data_)  ((void)0)
+
+#endif /* Q_SPY */
+
+#endif /* qsn_h */
@@ -7,10 +7,10 @@
  *  SimpleOS Controller File.
  *  Works with Task.h/.c.  Manages the OS and it's tasks.
  *  Requires at least one timer to run the scheduler.
+ *  The cpu parts are in the port, see SimpleOS_port.h.
  *
  */
 
-#include <msp430g2553.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -20,10 +20,32 @@
 #include "Task.h"
 
 //////////////////////////////////////////
-volatile uint16_t gStatusRegister = 0x00;        //enter/exit critical
 TaskStruct* RunPt;
+TaskStruct* NextPt;                             //set by the scheduler
 
 volatile uint32_t gTimerTick = 0x00;
+volatile uint8_t gTickPending = 0x00;          //set by the tick entry of the isr
+volatile uint8_t gLaunched = 0x00;              //threads are running
+
+#if SIMPLEOS_LOAD
+volatile uint32_t gRunTicks[MAXTHREADS];        //ticks each task block ran
+volatile uint32_t gIdleTicks = 0x00;            //ticks with nothing ready
+volatile uint8_t gLoadTicks = 0x00;             //ticks into the window
+volatile uint8_t gLoadIdle = 0x00;              //idle ticks in the window
+volatile uint8_t gLoadIdleLast = SIMPLEOS_LOAD_WINDOW;  //last window, all idle until one is done
+
+#if (SIMPLEOS_LOAD_WINDOW > 255) || (SIMPLEOS_LOAD_WINDOW == 0)
+#error "SIMPLEOS_LOAD_WINDOW must be 1 - 255"
+#endif
+#endif
+
+static void SimpleOS_suspend(void);
+static void SimpleOS_wait(void);
+static uint8_t SimpleOS_block(void* object, uint32_t timeout);
+static void SimpleOS_wakeOne(void* object);
+#if SIMPLEOS_LOAD
+static void SimpleOS_loadTick(void);
+#endif
 
 
 
@@ -32,13 +54,25 @@ volatile uint32_t gTimerTick = 0x00;
 /////////////////////////////////////////////
 //SimpleOS_init
 //Disable global interrupts, init the default task
-void SimpleOS_init(void (*functionPtr)(void))
+//priority - 0 is the highest
+//stack, stackSize - stack for the thread, size in words,
+//STACK_MIN or more, same as SimpleOS_addThread()
+//Returns 0, -1 if the stack is too small.  Nothing
+//runs if it fails, SimpleOS_launch() returns.
+int SimpleOS_init(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize)
 {
-    __bic_SR_register(GIE);     //disable all interrupts
+    SIMPLEOS_DISABLE();         //disable all interrupts
+
+    //threads that return go to SimpleOS_exit
+    Task_setExit(SimpleOS_exit);
 
     //returns the head of the TaskList
-    RunPt = Task_init(functionPtr);
+    RunPt = Task_init(functionPtr, priority, stack, stackSize);
 
+    if (RunPt == NULL)
+        return -1;
+
+    return 0;
 }
 
 
@@ -47,16 +81,37 @@ void SimpleOS_init(void (*functionPtr)(void))
 
 ///////////////////////////////////////////////////////
 //SimpleOS_addThread.
-//Append new task in the linked task list.  Update the
-//RunPt to the head of the list.
+//Append new task in the linked task list and make
+//it ready to run.  Can be called from a running
+//thread, a higher priority thread runs right away.
+//priority - 0 is the highest
+//stack, stackSize - stack for the thread, size in words,
+//STACK_MIN or more
+//Returns the thread number, -1 if there's no free
+//task block or the stack is too small.
 //
-void SimpleOS_addThread(void (*functionPtr)(void))
+int SimpleOS_addThread(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize)
 {
+    TaskStruct* task;
+
     SimpleOS_EnterCritical();
 
-    RunPt = Task_appendTask(functionPtr);
+    task = Task_appendTask(functionPtr, priority, stack, stackSize);
+
+#if SIMPLEOS_LOAD
+    if (task != NULL)
+        gRunTicks[task->index] = 0;     //block may have been used before
+#endif
+
+    if ((task != NULL) && (gLaunched) && (task->priority < RunPt->priority))
+        SimpleOS_suspend();
 
     SimpleOS_ExitCritical();
+
+    if (task == NULL)
+        return -1;
+
+    return task->index;
 }
 
 
@@ -64,212 +119,578 @@ void SimpleOS_addThread(void (*functionPtr)(void))
 
 /////////////////////////////////////////////////
 //Scheduler
-//Called in the SimpleOS_ISR.  Configure the
-//RunPt to the next task to run.  Check that RunPt
-//is not at the end of the list, if so, reset it to the head.
+//Called in the SimpleOS_ISR.  Set NextPt to
+//the next task to run, the highest
+//priority ready task.  If RunPt is at that
+//priority, the next one at the same priority
+//gets the timeslice (round robin).
+//On a tick, wake the sleeping tasks that are
+//done.  The tick entry of the isr sets
+//gTickPending, the switch from SimpleOS_suspend()
+//comes in on its own interrupt and doesn't, so
+//a switch never takes the place of a tick.  A
+//switch pended along with the tick is done by
+//this pass and cleared.  With SIMPLEOS_LOAD the tick
+//goes to RunPt, or idle if it's not ready.  Check
+//the stack of the thread going out.  The isr does
+//the switch if NextPt is not RunPt.
 void SimpleOS_scheduler(void)
 {
-    gTimerTick++;
+    Task_checkStack(RunPt);
 
-//    RunPt = RunPt;
-    //Update RunPt - check not at the end of the list
-    if ((RunPt->next) != NULL)
-        RunPt = RunPt->next;
+    SIMPLEOS_CLEAR_SWITCH();
 
-    else
-        RunPt = Task_getHead();     //reset to the head
+    if (gTickPending)
+    {
+        gTickPending = 0;
+        gTimerTick++;
+#if SIMPLEOS_LOAD
+        SimpleOS_loadTick();
+#endif
+        Task_tick();
+    }
+
+    NextPt = Task_getNextReady(RunPt);
 }
 
 
 /////////////////////////////////////////////
-//Start SimpleOS
+//Start SimpleOS.  Doesn't return unless
+//SimpleOS_init() failed.
 void SimpleOS_launch(void)
 {
+    if (RunPt == NULL)
+        return;
+
+    //start with the highest priority task
+    RunPt = Task_getHighestReady();
+    NextPt = RunPt;
+    gLaunched = 1;
+
+    SIMPLEOS_SWITCH_INIT();
+
+#if SIMPLEOS_PROFILE
+    SIMPLEOS_PROFILE_TIMER_START();
+#endif
+
     //configure stack and start first task
     SimpleOS_start();
 }
 
 
-/////////////////////////////////////////////////////
-//Configure the stack to launch the first task
-//map the stack pointer to RunPt-sp, pop the contents
-//in the task block into R5-R15.  enable interrupts
-void __attribute__((naked))
-SimpleOS_start(void)
+/////////////////////////////////////////
+//SimpleOS_yield
+//Give up the rest of the timeslice.  The next
+//ready thread at the same priority runs, or a
+//higher priority one if any are ready.  If there
+//are none, this thread keeps running.  The
+//switch isn't a tick, the next thread gets
+//what's left of the timeslice.
+void SimpleOS_yield(void)
 {
-    //Set SP to the contents of RunPt->sp
-    __asm("MOV &RunPt, SP\n");      //set SP = address of RunPt
-    __asm("MOV @SP, SP\n");         //set SP = contents in SP
-
-    __asm("POP R5\n");              //R5 = stack - 15
-    __asm("POP R6\n");              //R6 = stack - 14
-    __asm("POP R7\n");              //R7 = stack - 13
-    __asm("POP R8\n");              //R8 = stack - 12
-    __asm("POP R9\n");              //R9 = stack - 11
-    __asm("POP R10\n");             //R10 = stack - 10
-    __asm("POP R11\n");             //R11 = stack - 9
-    __asm("POP R12\n");             //R12 = stack - 8
-    __asm("POP R13\n");             //R13 = stack - 7
-    __asm("POP R14\n");             //R14 = stack - 6
-    __asm("POP R15\n");             //R15 = stack - 5
-
-    //NOTE: This should result in the address of SP looking at
-    //the contents of function pointer. - ie, set FunctionPtr = stack - 5
-    //If it's off, adjust the location of the initial function ptr
-    //or try the following:
-    //   __asm("MOV  SP, R15\n");        //set R15 = SP (address and contents)
-    //   __asm("INC R15\n");             //increment R15 - word aligned
-    //   __asm("INC R15\n");             //increment R15 - word aligned
-    //          ....
-    //          ....
-    //   __asm("MOV R15, SP\n");         //set SP = R15
-
-   __bis_SR_register(GIE);          //enable global interrupts
-
-   //PC loaded with contents of SP - the address we return to
-   __asm("RET\n");
-}
+    SIMPLEOS_DISABLE();             //disable
 
+    SimpleOS_suspend();
 
+    SIMPLEOS_ENABLE();              //enable, isr runs here
+}
 
 
-//////////////////////////////////////////////////
-//SimpleOS_EnterCritical.
-//Save the status register R2 and disable interrupts
-//I'm guessing this goes in R4 if you want to return it.
-void __attribute__((naked))
-SimpleOS_EnterCritical(void)
+/////////////////////////////////////////
+//SimpleOS_exit
+//End the running thread.  Threads waiting in
+//SimpleOS_join() on it are made ready and the
+//task block goes back on the free list, the
+//caller's stack can be used again after this.
+//A thread function that returns ends up here.
+//Doesn't return.
+void SimpleOS_exit(void)
 {
-    __asm("MOV SR, &gStatusRegister\n");
-    __bic_SR_register(GIE);         //disable
-    __asm("RET\n");
-}
+    TaskStruct* task;
 
+    SIMPLEOS_DISABLE();             //disable
 
+    while ((task = Task_getBlocked(RunPt)) != NULL)
+    {
+        task->blockPt = NULL;
+        Task_setReady(task);
+    }
 
-//////////////////////////////////////////////////
-//SimpleOS_EnterCritical.
-//Save the status register R2 and disable interrupts
-//I'm guessing this goes in R4 if you want to return it.
-//
-//NOTE: Status shows up in R12.  Can't be for sure if it's
-//always that way.
-void __attribute__((naked))
-SimpleOS_ExitCritical(void)
-{
-    __asm("MOV &gStatusRegister, SR\n");
-    __asm("RET\n");
+    Task_clearReady(RunPt);
+    Task_freeTask(RunPt);
+
+    //never ready again.  If nothing else is ready
+    //it idles in here until something is.
+    SimpleOS_wait();
+
+    while (1){};
 }
 
 
-//////////////////////////////////////////////////////////
-//SimpleOS_ISR
-//Called from periodically from a timer interrupt.
-//This function performs the context switch.  The process:
-//
-// - Disable interrupts
-// - Push CPU registers onto the stack.
-// - Save SP into the current RunPt->sp through use of R4.
-// - Update the RunPt by calling the scheduler.
-// - Set the new SP  = RunPt-sp through the use of R4.
-// - Pop R5-R15 using stack values mapped to new RunPt-sp.
-// - Enable interrupts
-//
-//
-void __attribute__((naked))
-SimpleOS_ISR(void)
+/////////////////////////////////////////
+//SimpleOS_join
+//Wait for a thread to exit.  Returns 0 when
+//it has, right away if it's not running.
+//Returns -1 if the thread is the caller.
+//Thread numbers are reused, join before adding
+//another thread.
+int SimpleOS_join(uint8_t thread)
 {
-    __bic_SR_register(GIE);         //disable interrupts
-
-    //save R5 - R15 into the current RunPt stack
-    __asm("PUSH R5\n");
-    __asm("PUSH R6\n");
-    __asm("PUSH R7\n");
-    __asm("PUSH R8\n");
-    __asm("PUSH R9\n");
-    __asm("PUSH R10\n");
-    __asm("PUSH R11\n");
-    __asm("PUSH R12\n");
-    __asm("PUSH R13\n");
-    __asm("PUSH R14\n");
-    __asm("PUSH R15\n");
-
-    //Save the old stack pointer
-    __asm("MOV  &RunPt, R4\n");             //set R4 = RunPt
-    __asm("MOV SP, @R4\n");                 //save SP into contents of R4, setting RunPt->sp = SP
-
-    //update the new RunPt and set the new SP
-    __asm("CALL #SimpleOS_scheduler\n");    //update RunPt by calling the scheduler
-    __asm("MOV  &RunPt, R4\n");             //set R4 = RunPt
-    __asm("MOV @R4, SP");                   //set contents of R4 (RunPt->sp) to SP.  ie, set SP to the new RunPt-sp
-
-
-    //update R5 - R15 with the contents of new RunPt stack.
-    //ie, since SP = RunPt->sp, push / pop opperations
-    //work on the new stack location
-    __asm("POP R5\n");
-    __asm("POP R6\n");
-    __asm("POP R7\n");
-    __asm("POP R8\n");
-    __asm("POP R9\n");
-    __asm("POP R10\n");
-    __asm("POP R11\n");
-    __asm("POP R12\n");
-    __asm("POP R13\n");
-    __asm("POP R14\n");
-    __asm("POP R15\n");
-
-    //NOTE: The timer counter is still counting
-    //regardless if interrupts are disabled. Reset
-    //the counter here
-    __asm("MOV #0, &TA0R\n");
-
-    //enable all the interrupts
-    __bis_SR_register(GIE);
-
-    //NOTE: The return from interrupt call is RETI
-    __asm("RET\n");
+    TaskStruct* task;
+
+    SIMPLEOS_DISABLE();             //disable
+
+    task = Task_getTask(thread);
+
+    if (task == RunPt)
+    {
+        SIMPLEOS_ENABLE();          //enable
+        return -1;
+    }
+
+    if (task != NULL)
+    {
+        RunPt->blockPt = task;
+        Task_clearReady(RunPt);
+
+        SimpleOS_wait();
+        return 0;
+    }
+
+    SIMPLEOS_ENABLE();              //enable
+    return 0;
 }
 
 
 /////////////////////////////////////////
 //Delay as function of the timeslice.
+//The thread goes in the sleep list and the
+//next thread runs.  The tick makes it ready
+//again after delay ticks.
 void SimpleOS_delay(uint32_t delay)
 {
-    volatile uint32_t temp = delay + gTimerTick;
+    if (!delay)
+        return;
 
+    SIMPLEOS_DISABLE();             //disable
 
+    Task_clearReady(RunPt);
+    Task_sleep(RunPt, delay);
 
-    while (temp > gTimerTick){};
-
+    SimpleOS_wait();
 }
 
 
 //////////////////////////////////////////////
-//Spinlock semaphore wait.
+//Semaphore wait.  Take one from the semaphore,
+//if there wasn't one the thread is blocked until
+//SimpleOS_semaphoreSignal() gives it one.  A
+//negative count is the number of threads waiting.
 void SimpleOS_semaphoreWait(int16_t* signal)
 {
-    __bic_SR_register(GIE);         //disable
+    SIMPLEOS_DISABLE();             //disable
+
+    (*signal) = (*signal) - 1;
 
-    while ((*signal) < 1)
+    if ((*signal) < 0)
     {
-        __bis_SR_register(GIE);     //enable
-        __bic_SR_register(GIE);     //disable
+        RunPt->blockPt = signal;
+        Task_clearReady(RunPt);
+
+        SimpleOS_wait();
+        return;
     }
 
-    (*signal) = (*signal) - 1;
-    __bis_SR_register(GIE);         //enable
+    SIMPLEOS_ENABLE();              //enable
 }
 
 
 
 ////////////////////////////////////////////////
-//Signal the semaphore
+//Signal the semaphore.  If threads are waiting,
+//the highest priority one is made ready.  Switch
+//to it now if it's higher priority than this
+//thread.  Call from a thread, not an isr.
 void SimpleOS_semaphoreSignal(int16_t* signal)
 {
-    __bic_SR_register(GIE);         //disable
+    SIMPLEOS_DISABLE();             //disable
+
     (*signal) = (*signal) + 1;
-    __bis_SR_register(GIE);         //enable
+
+    if ((*signal) <= 0)
+        SimpleOS_wakeOne(signal);
+
+    SIMPLEOS_ENABLE();              //enable
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_mutexInit
+void SimpleOS_mutexInit(MutexStruct* mutex)
+{
+    mutex->owner = NULL;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_mutexLock
+//Lock the mutex, block until it's unlocked if
+//another thread has it.  While blocked, the owner
+//runs at this thread's priority if it's lower.
+//Only the owner is raised, not a thread the owner
+//is waiting on.  Don't lock a mutex twice and
+//don't exit holding one.  Call from a thread,
+//not an isr.
+void SimpleOS_mutexLock(MutexStruct* mutex)
+{
+    SIMPLEOS_DISABLE();             //disable
+
+    while (mutex->owner != NULL)
+    {
+        if (RunPt->priority < mutex->owner->priority)
+            Task_setPriority(mutex->owner, RunPt->priority);
+
+        SimpleOS_block(mutex, SIMPLEOS_WAIT_FOREVER);
+    }
+
+    mutex->owner = RunPt;
+    RunPt->mutexHeld++;
+
+    SIMPLEOS_ENABLE();              //enable
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_mutexUnlock
+//Unlock the mutex and make the highest priority
+//thread waiting on it ready.  The owner goes back
+//to it's own priority when it has no more mutexes
+//locked, so a raised owner holding two stays up
+//until both are unlocked.  Returns 0, -1 if this
+//thread isn't the owner.
+int SimpleOS_mutexUnlock(MutexStruct* mutex)
+{
+    TaskStruct* task;
+
+    SIMPLEOS_DISABLE();             //disable
+
+    if (mutex->owner != RunPt)
+    {
+        SIMPLEOS_ENABLE();          //enable
+        return -1;
+    }
+
+    mutex->owner = NULL;
+
+    if (--RunPt->mutexHeld == 0)
+        Task_setPriority(RunPt, RunPt->basePriority);
+
+    SimpleOS_wakeOne(mutex);
+
+    //dropped below a thread that's ready, let it run
+    task = Task_getHighestReady();
+
+    if (task->priority < RunPt->priority)
+        SimpleOS_suspend();
+
+    SIMPLEOS_ENABLE();              //enable
+    return 0;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_queueInit
+//Set up a queue of size int16_t messages in
+//buffer.  A queue of size 1 is a mailbox.
+void SimpleOS_queueInit(QueueStruct* queue, int16_t* buffer, uint8_t size)
+{
+    queue->buffer = buffer;
+    queue->size = size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->count = 0;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_queueSend
+//Put a message at the end of the queue.  If it's
+//full, block until a receiver makes room or for
+//timeout ticks.  timeout 0 doesn't wait,
+//SIMPLEOS_WAIT_FOREVER waits with no timeout.
+//A thread waiting to receive is made ready.
+//Returns 0 if sent, -1 if full (timed out).
+//Call from a thread, not an isr.
+int SimpleOS_queueSend(QueueStruct* queue, int16_t msg, uint32_t timeout)
+{
+    SIMPLEOS_DISABLE();             //disable
+
+    while (queue->count >= queue->size)
+    {
+        //senders wait on the size, receivers on the count
+        if (!SimpleOS_block(&queue->size, timeout))
+        {
+            SIMPLEOS_ENABLE();      //enable
+            return -1;
+        }
+    }
+
+    queue->buffer[queue->head] = msg;
+    queue->head = (queue->head + 1 < queue->size) ? (queue->head + 1) : 0;
+    queue->count++;
+
+    SimpleOS_wakeOne(&queue->count);
+
+    SIMPLEOS_ENABLE();              //enable
+    return 0;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_queueReceive
+//Take the oldest message from the queue.  If it's
+//empty, block until a sender posts one or for
+//timeout ticks, same as SimpleOS_queueSend.  A
+//thread waiting to send is made ready.
+//Returns 0 and loads msg, -1 if empty (timed out).
+//Call from a thread, not an isr.
+int SimpleOS_queueReceive(QueueStruct* queue, int16_t* msg, uint32_t timeout)
+{
+    SIMPLEOS_DISABLE();             //disable
+
+    while (queue->count == 0)
+    {
+        if (!SimpleOS_block(&queue->count, timeout))
+        {
+            SIMPLEOS_ENABLE();      //enable
+            return -1;
+        }
+    }
+
+    *msg = queue->buffer[queue->tail];
+    queue->tail = (queue->tail + 1 < queue->size) ? (queue->tail + 1) : 0;
+    queue->count--;
+
+    SimpleOS_wakeOne(&queue->size);
+
+    SIMPLEOS_ENABLE();              //enable
+    return 0;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_block
+//Block the running thread on object for up to
+//timeout ticks.  Returns 1 if it was woken by
+//SimpleOS_wakeOne(), 0 if it timed out or the
+//timeout was 0.  A timeout leaves blockPt set,
+//the tick only makes the thread ready.
+//Call with interrupts disabled, returns with
+//them disabled.
+static uint8_t SimpleOS_block(void* object, uint32_t timeout)
+{
+    if (!timeout)
+        return 0;
+
+    RunPt->blockPt = object;
+    Task_clearReady(RunPt);
+
+    if (timeout != SIMPLEOS_WAIT_FOREVER)
+        Task_sleep(RunPt, timeout);
+
+    SimpleOS_wait();
+
+    SIMPLEOS_DISABLE();             //disable
+
+    if (RunPt->blockPt != NULL)
+    {
+        RunPt->blockPt = NULL;      //timed out
+        return 0;
+    }
+
+    return 1;
+}
+
+
+////////////////////////////////////////////////
+//SimpleOS_wakeOne
+//Make the highest priority thread blocked on
+//object ready, take it out of the sleep list if
+//it has a timeout.  Switch to it now if it's
+//higher priority than this thread.
+//Call with interrupts disabled.
+static void SimpleOS_wakeOne(void* object)
+{
+    TaskStruct* task = Task_getBlocked(object);
+
+    if (task != NULL)
+    {
+        task->blockPt = NULL;
+        Task_sleepRemove(task);
+        Task_setReady(task);
+
+        if (task->priority < RunPt->priority)
+            SimpleOS_suspend();
+    }
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_getStackUsed
+//Most words of it's stack the thread has used.
+//Returns 0 for a bad thread number.
+uint16_t SimpleOS_getStackUsed(uint8_t thread)
+{
+    TaskStruct* task = Task_getTask(thread);
+
+    if (task != NULL)
+        return Task_getStackUsed(task);
+
+    return 0;
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_getStackOverflow
+//Returns 1 if the thread's stack has overflowed,
+//0 if not or a bad thread number.  Once set it
+//stays set, ram past the stack got written over.
+uint8_t SimpleOS_getStackOverflow(uint8_t thread)
+{
+    TaskStruct* task = Task_getTask(thread);
+
+    if (task != NULL)
+        return task->overflow;
+
+    return 0;
+}
+
+
+#if SIMPLEOS_LOAD
+//////////////////////////////////////////////
+//SimpleOS_getLoad
+//Percent of the last SIMPLEOS_LOAD_WINDOW ticks
+//that weren't idle.  0 until the first window
+//is done.
+uint8_t SimpleOS_getLoad(void)
+{
+    return (uint8_t)(100 - ((uint16_t)gLoadIdleLast * 100) / SIMPLEOS_LOAD_WINDOW);
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_getRunTicks
+//Ticks the thread has been running since it was
+//added or the last reset.  0 for a bad thread number.
+uint32_t SimpleOS_getRunTicks(uint8_t thread)
+{
+    uint32_t ticks = 0;
+
+    SimpleOS_EnterCritical();
+
+    if (Task_getTask(thread) != NULL)
+        ticks = gRunTicks[thread];
+
+    SimpleOS_ExitCritical();
+
+    return ticks;
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_getIdleTicks
+//Ticks with no thread ready since the last reset.
+uint32_t SimpleOS_getIdleTicks(void)
+{
+    uint32_t ticks;
+
+    SimpleOS_EnterCritical();
+    ticks = gIdleTicks;
+    SimpleOS_ExitCritical();
+
+    return ticks;
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_resetLoad
+//Clear the run and idle ticks.  The window keeps
+//going.
+void SimpleOS_resetLoad(void)
+{
+    SimpleOS_EnterCritical();
+
+    for (uint8_t i = 0 ; i < MAXTHREADS ; i++)
+        gRunTicks[i] = 0;
+
+    gIdleTicks = 0;
+
+    SimpleOS_ExitCritical();
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_loadTick
+//Called on every tick from the scheduler, before
+//the switch.  A RunPt that isn't ready is idling
+//in SimpleOS_wait().
+static void SimpleOS_loadTick(void)
+{
+    if (Task_isReady(RunPt))
+        gRunTicks[RunPt->index]++;
+
+    else
+    {
+        gIdleTicks++;
+        gLoadIdle++;
+    }
+
+    if (++gLoadTicks >= SIMPLEOS_LOAD_WINDOW)
+    {
+        gLoadIdleLast = gLoadIdle;
+        gLoadIdle = 0;
+        gLoadTicks = 0;
+    }
+}
+#endif
+
+
+//////////////////////////////////////////////
+//SimpleOS_suspend
+//Switch threads now instead of at the end of
+//the timeslice.  Pends the switch interrupt (the
+//CCR1 flag on the msp430) so the SimpleOS_ISR runs
+//as soon as interrupts are enabled.  It's a
+//different flag from the tick, so a tick that
+//comes in while the switch is pending still
+//counts.
+//Call with interrupts disabled.
+static void SimpleOS_suspend(void)
+{
+    SIMPLEOS_PEND_SWITCH();
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_wait
+//Give up the cpu until RunPt is ready again.
+//The switch happens when SIMPLEOS_IDLE() enables
+//interrupts and sleeps.  If nothing else is ready the
+//scheduler comes back to this thread, so it
+//sleeps here until a tick or signal makes
+//something ready.  This is the idle loop.
+//Call with interrupts disabled, returns with
+//them enabled.
+static void SimpleOS_wait(void)
+{
+    SimpleOS_suspend();
+
+    while (!Task_isReady(RunPt))
+    {
+        SIMPLEOS_IDLE();
+    }
+
+    SIMPLEOS_ENABLE();              //enable
 }
 
 
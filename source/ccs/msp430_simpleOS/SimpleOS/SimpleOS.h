@@ -7,30 +7,154 @@
  *  SimpleOS header file.  Works with Task.h/.c
  *  Manages the OS as tasks.  Requires at least one
  *  timer to run the schduler.
+ *
+ *  Threads have a priority, 0 is the highest.  Each
+ *  timeslice runs the highest priority ready thread,
+ *  threads at the same priority take turns.
+ *
+ *  SimpleOS_delay() and SimpleOS_semaphoreWait() take
+ *  the thread off the ready list until the tick or
+ *  SimpleOS_semaphoreSignal() wakes it, so waiting
+ *  threads don't use any cpu.  When nothing is ready
+ *  the cpu sleeps in SIMPLEOS_IDLE_LPM_BITS.
+ *
+ *  SimpleOS_ISR() is the timer interrupt, on
+ *  SIMPLEOS_TIMER_VECTOR.  The timer is set up by the
+ *  application, with the CCR0 interrupt on.  Switches
+ *  between ticks come in on SIMPLEOS_SWITCH_VECTOR,
+ *  set up by SimpleOS_launch().
+ *
+ *  A thread that's done before the end of it's
+ *  timeslice can hand the cpu to the next ready
+ *  thread with SimpleOS_yield().
+ *
+ *  Each thread gets a stack from the caller, at least
+ *  STACK_MIN words.  The stacks are painted so the
+ *  most each thread has used can be read with
+ *  SimpleOS_getStackUsed().  The bottom word is checked
+ *  every time a thread is switched out, see
+ *  SimpleOS_getStackOverflow().  Threads are numbered
+ *  in the order they're added, starting at 0.
+ *
+ *  Threads can be added while the OS is running.  A
+ *  thread ends with SimpleOS_exit() or by returning
+ *  from it's function, it's task block is reused and
+ *  other threads can wait for it with SimpleOS_join().
+ *
+ *  Threads pass int16_t messages through queues with
+ *  SimpleOS_queueSend() and SimpleOS_queueReceive().
+ *  Both block with a timeout when the queue is full
+ *  or empty.  The buffer comes from the caller.
+ *
+ *  A mutex is for a resource like a bus that one thread
+ *  uses at a time.  A thread waiting to lock it lends
+ *  it's priority to the owner until the owner unlocks,
+ *  so a low priority owner can't be held off by the
+ *  threads in between (priority inheritance).
+ *
+ *  With SIMPLEOS_LOAD, the tick counts the ticks each
+ *  thread runs and the ticks idle.  SimpleOS_getLoad()
+ *  is the percent busy over the last load window.
+ *
+ *  The parts that depend on the cpu are in the port,
+ *  SimpleOS_msp430.h/.c, picked in SimpleOS_port.h.
+ *  The same scheduler runs on a host in
+ *  source/host/simpleOS_posix.
  */
 
 #ifndef SIMPLEOS_SIMPLEOS_H_
 #define SIMPLEOS_SIMPLEOS_H_
 
+#include <stdint.h>
+
+#include "SimpleOS_port.h"      //timer vector, idle and profile settings
+
+
+////////////////////////////////////
+//Load.  Set SIMPLEOS_LOAD to 1 to count the ticks
+//each thread runs and the ticks spent idle, see
+//SimpleOS_getLoad().  Each load reading is over
+//SIMPLEOS_LOAD_WINDOW ticks.  The tick goes to the
+//thread running when it comes, so it's a sample,
+//not an exact count.
+#ifndef SIMPLEOS_LOAD
+#define SIMPLEOS_LOAD               0
+#endif
+
+#ifndef SIMPLEOS_LOAD_WINDOW
+#define SIMPLEOS_LOAD_WINDOW        100
+#endif
+
+
+////////////////////////////////////
+//Message queue, ring buffer of int16_t
+//messages in a buffer from the caller
+typedef struct
+{
+    int16_t* buffer;                //size messages
+    uint8_t size;                   //max messages
+    uint8_t head;                   //next to write
+    uint8_t tail;                   //next to read
+    uint8_t count;                  //messages waiting
+}QueueStruct;
+
+#define SIMPLEOS_WAIT_FOREVER       0xFFFFFFFF      //no timeout
+
+
+////////////////////////////////////
+//Mutex, owned by the thread that locked it
+typedef struct
+{
+    struct taskStruct* owner;       //NULL when unlocked
+}MutexStruct;
+
 
 ////////////////////////////////////
 //OS Stuff
-void SimpleOS_init(void (*functionPtr)(void));
-void SimpleOS_addThread(void (*functionPtr)(void));
+int SimpleOS_init(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize);
+int SimpleOS_addThread(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize);
+void SimpleOS_exit(void);
+int SimpleOS_join(uint8_t thread);
 
 void SimpleOS_scheduler(void);
 void SimpleOS_launch(void);
 void SimpleOS_start(void);
 void SimpleOS_ISR(void);
+void SimpleOS_switchISR(void);
 
 void SimpleOS_EnterCritical(void);
 void SimpleOS_ExitCritical(void);
 
 
+void SimpleOS_yield(void);
 void SimpleOS_delay(uint32_t delay);
 void SimpleOS_semaphoreWait(int16_t* signal);
 void SimpleOS_semaphoreSignal(int16_t* signal);
 
+void SimpleOS_mutexInit(MutexStruct* mutex);
+void SimpleOS_mutexLock(MutexStruct* mutex);
+int SimpleOS_mutexUnlock(MutexStruct* mutex);
+
+void SimpleOS_queueInit(QueueStruct* queue, int16_t* buffer, uint8_t size);
+int SimpleOS_queueSend(QueueStruct* queue, int16_t msg, uint32_t timeout);
+int SimpleOS_queueReceive(QueueStruct* queue, int16_t* msg, uint32_t timeout);
+
+uint16_t SimpleOS_getStackUsed(uint8_t thread);
+uint8_t SimpleOS_getStackOverflow(uint8_t thread);
+
+#if SIMPLEOS_LOAD
+uint8_t SimpleOS_getLoad(void);
+uint32_t SimpleOS_getRunTicks(uint8_t thread);
+uint32_t SimpleOS_getIdleTicks(void);
+void SimpleOS_resetLoad(void);
+#endif
+
+#if SIMPLEOS_PROFILE
+uint16_t SimpleOS_getSwitchCycles(void);
+uint16_t SimpleOS_getSwitchCyclesMax(void);
+void SimpleOS_resetSwitchCycles(void);
+#endif
+
 
 
 #endif /* SIMPLEOS_SIMPLEOS_H_ */
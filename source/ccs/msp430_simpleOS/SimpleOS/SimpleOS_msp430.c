@@ -0,0 +1,284 @@
+/*
+ * SimpleOS_msp430.c
+ *
+ *  SimpleOS port for the msp430g2553, see SimpleOS_port.h.
+ *  The first switch, the timer isr that switches threads,
+ *  the critical sections and the frame on a new stack.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "SimpleOS.h"
+#include "Task.h"
+
+//////////////////////////////////////////
+volatile uint16_t gStatusRegister = 0x00;        //enter/exit critical
+
+#if SIMPLEOS_PROFILE
+volatile uint16_t gSwitchStart = 0x00;          //TA1R at isr entry
+volatile uint16_t gSwitchCycles = 0x00;         //last isr, entry to RETI
+volatile uint16_t gSwitchCyclesMax = 0x00;      //longest isr
+#endif
+
+
+/////////////////////////////////////////////////////
+//Configure the stack to launch the first task
+//map the stack pointer to RunPt-sp, pop the contents
+//in the task block into R4-R15.  RETI pops the SR
+//(GIE set) and the PC (the task function), same as
+//returning from the SimpleOS_ISR.
+void __attribute__((naked))
+SimpleOS_start(void)
+{
+    //Set SP to the contents of RunPt->sp
+    __asm("MOV &RunPt, SP\n");      //set SP = address of RunPt
+    __asm("MOV @SP, SP\n");         //set SP = contents in SP
+
+    __asm("POP R4\n");              //R4 = stack - 15
+    __asm("POP R5\n");              //R5 = stack - 14
+    __asm("POP R6\n");              //R6 = stack - 13
+    __asm("POP R7\n");              //R7 = stack - 12
+    __asm("POP R8\n");              //R8 = stack - 11
+    __asm("POP R9\n");              //R9 = stack - 10
+    __asm("POP R10\n");             //R10 = stack - 9
+    __asm("POP R11\n");             //R11 = stack - 8
+    __asm("POP R12\n");             //R12 = stack - 7
+    __asm("POP R13\n");             //R13 = stack - 6
+    __asm("POP R14\n");             //R14 = stack - 5
+    __asm("POP R15\n");             //R15 = stack - 4
+
+    //SR = stack - 3, PC = stack - 2, the function
+    //returns to stack - 1 (SimpleOS_exit)
+    __asm("RETI\n");
+}
+
+
+
+//////////////////////////////////////////////////
+//SimpleOS_EnterCritical.
+//Save the status register R2 and disable interrupts
+//I'm guessing this goes in R4 if you want to return it.
+void __attribute__((naked))
+SimpleOS_EnterCritical(void)
+{
+    __asm("MOV SR, &gStatusRegister\n");
+    __bic_SR_register(GIE);         //disable
+    __asm("RET\n");
+}
+
+
+
+//////////////////////////////////////////////////
+//SimpleOS_EnterCritical.
+//Save the status register R2 and disable interrupts
+//I'm guessing this goes in R4 if you want to return it.
+//
+//NOTE: Status shows up in R12.  Can't be for sure if it's
+//always that way.
+void __attribute__((naked))
+SimpleOS_ExitCritical(void)
+{
+    __asm("MOV &gStatusRegister, SR\n");
+    __asm("RET\n");
+}
+
+
+//////////////////////////////////////////////////////////
+//SimpleOS_ISR
+//The timer interrupt, a tick.  Sets gTickPending
+//and goes on to SimpleOS_switchISR, the switch
+//is the same for both.
+//
+void __attribute__((naked, interrupt(SIMPLEOS_TIMER_VECTOR)))
+SimpleOS_ISR(void)
+{
+#if SIMPLEOS_PROFILE
+    __asm("MOV &TA1R, &gSwitchStart\n");
+#endif
+
+    __asm("MOV.B #1, &gTickPending\n");    //a tick, not only a switch
+    __asm("BR #SimpleOS_ISR_switch\n");
+}
+
+
+//////////////////////////////////////////////////////////
+//SimpleOS_switchISR
+//The CCR1 interrupt pended by SimpleOS_suspend(), and
+//the rest of the tick.  Performs the context switch.
+//The cpu has pushed the PC and SR and disabled
+//interrupts on the way in.  The process:
+//
+// - Push R11-R15, the registers the scheduler can use.
+// - Save SP into RunPt->sp, the scheduler checks it
+//   against the bottom of the stack.
+// - Call the scheduler to set NextPt.
+// - If NextPt is RunPt, skip to the end (no switch).
+// - Push R4-R10, save SP into RunPt->sp.
+// - RunPt = NextPt, set SP = RunPt->sp.
+// - Pop R4-R10 from the new stack.
+// - Pop R11-R15, clear the low power bits in the
+//   stacked SR so a thread idling in SimpleOS_wait()
+//   wakes up, RETI pops the SR (with GIE) and PC.
+//
+//Every thread stack looks the same when it's not
+//running: PC, SR, R15-R11, R10-R4, SP at R4.
+//
+//A tick that comes in while this runs waits for
+//the RETI, the CCR0 flag stays set until then.
+//
+//With SIMPLEOS_PROFILE, the cycles from entry to
+//RETI are kept in gSwitchCycles and gSwitchCyclesMax.
+//The 6 cycles to get into the isr are not counted.
+//
+//Cycles counted from the instruction table in the
+//x2xx user's guide, with the 6 to get in and the
+//RETI, without the scheduler itself or the profile
+//code.  gSwitchCycles leaves out the 6 and the RETI
+//and adds the scheduler.
+//
+//                               no switch   switch
+//  tick, CCR0                       68        119
+//  switch only, CCR1                61        112
+//  old C isr in main.c calling
+//  SimpleOS_ISR, all registers     about 122 either way
+//
+void __attribute__((naked, interrupt(SIMPLEOS_SWITCH_VECTOR)))
+SimpleOS_switchISR(void)
+{
+#if SIMPLEOS_PROFILE
+    __asm("MOV &TA1R, &gSwitchStart\n");
+#endif
+
+    __asm("SimpleOS_ISR_switch:\n");
+
+    //save the registers a C function can change
+    __asm("PUSH R15\n");
+    __asm("PUSH R14\n");
+    __asm("PUSH R13\n");
+    __asm("PUSH R12\n");
+    __asm("PUSH R11\n");
+
+    //live SP for Task_checkStack()
+    __asm("MOV &RunPt, R12\n");             //R12 = RunPt
+    __asm("MOV SP, 0(R12)\n");              //RunPt->sp = SP
+
+    __asm("CALL #SimpleOS_scheduler\n");    //set NextPt
+
+    //same thread, nothing else to save
+    __asm("CMP &RunPt, &NextPt\n");
+    __asm("JEQ SimpleOS_ISR_exit\n");
+
+    //save R4 - R10 and the SP of the old thread
+    __asm("PUSH R10\n");
+    __asm("PUSH R9\n");
+    __asm("PUSH R8\n");
+    __asm("PUSH R7\n");
+    __asm("PUSH R6\n");
+    __asm("PUSH R5\n");
+    __asm("PUSH R4\n");
+    __asm("MOV &RunPt, R12\n");             //R12 = RunPt
+    __asm("MOV SP, 0(R12)\n");              //RunPt->sp = SP
+
+    //switch to the new thread
+    __asm("MOV &NextPt, R12\n");            //R12 = NextPt
+    __asm("MOV R12, &RunPt\n");             //RunPt = NextPt
+    __asm("MOV @R12, SP\n");                //SP = RunPt->sp
+    __asm("POP R4\n");
+    __asm("POP R5\n");
+    __asm("POP R6\n");
+    __asm("POP R7\n");
+    __asm("POP R8\n");
+    __asm("POP R9\n");
+    __asm("POP R10\n");
+
+    __asm("SimpleOS_ISR_exit:\n");
+    __asm("POP R11\n");
+    __asm("POP R12\n");
+    __asm("POP R13\n");
+    __asm("POP R14\n");
+    __asm("POP R15\n");
+
+    //leave low power on the way out, SP is at the SR
+    __asm("BIC #0x00F0, 0(SP)\n");         //CPUOFF, OSCOFF, SCG0, SCG1
+
+#if SIMPLEOS_PROFILE
+    __asm("MOV &TA1R, &gSwitchCycles\n");
+    __asm("SUB &gSwitchStart, &gSwitchCycles\n");
+    __asm("CMP &gSwitchCycles, &gSwitchCyclesMax\n");
+    __asm("JHS SimpleOS_ISR_reti\n");       //max >= cycles
+    __asm("MOV &gSwitchCycles, &gSwitchCyclesMax\n");
+    __asm("SimpleOS_ISR_reti:\n");
+#endif
+
+    __asm("RETI\n");
+}
+
+
+/////////////////////////////////////////////////////////
+//Task_initFrame
+//Set the function to run in a position such that after
+//the pops and RETI in the OS start / context switch routines,
+//it lands on the function to run.  The stack is already
+//painted by Task_initStack().
+void Task_initFrame(TaskStruct* task, void (*functionPtr)(void), void (*exitPtr)(void))
+{
+    uint16_t stackSize = task->stackSize;
+
+    //Same as a thread stopped by the SimpleOS_ISR.
+    //RETI pops the SR and then the PC.  The word on
+    //top is the return address, if the function
+    //returns it goes to the exit function.
+    task->stack[stackSize-1] = (int16_t)exitPtr;       // return address of the function
+    task->stack[stackSize-2] = (int16_t)functionPtr;   // PC - function to run
+    task->stack[stackSize-3] = (0x0008);   // SR - GIE set
+    task->stack[stackSize-4] = (0x0FF0);   // R15
+    task->stack[stackSize-5] = (0x0EE0);   // R14
+    task->stack[stackSize-6] = (0x0DD0);   // R13
+    task->stack[stackSize-7] = (0x0CC0);   // R12
+    task->stack[stackSize-8] = (0x0BB0);   // R11 - last of the caller saved
+    task->stack[stackSize-9] = (0x0AA0);   // R10
+    task->stack[stackSize-10] = (0x0990);  // R9
+    task->stack[stackSize-11] = (0x0880);  // R8
+    task->stack[stackSize-12] = (0x0770);  // R7
+    task->stack[stackSize-13] = (0x0660);  // R6
+    task->stack[stackSize-14] = (0x0550);  // R5
+    task->stack[stackSize-15] = (0x0440);  // R4 - first pop
+
+    //set the initial stack pointer location, STACK_FRAME
+    //words down from the top.  pop - increment the SP,
+    //push - decrement the sp.
+    task->sp = &task->stack[stackSize - STACK_FRAME]; //SP
+}
+
+
+#if SIMPLEOS_PROFILE
+//////////////////////////////////////////////
+//SimpleOS_getSwitchCycles
+//Cycles in the last timer isr, from entry to
+//RETI.  A tick without a switch is shorter.
+uint16_t SimpleOS_getSwitchCycles(void)
+{
+    return gSwitchCycles;
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_getSwitchCyclesMax
+//Longest timer isr since the last reset.
+uint16_t SimpleOS_getSwitchCyclesMax(void)
+{
+    return gSwitchCyclesMax;
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_resetSwitchCycles
+void SimpleOS_resetSwitchCycles(void)
+{
+    gSwitchCyclesMax = 0;
+}
+#endif
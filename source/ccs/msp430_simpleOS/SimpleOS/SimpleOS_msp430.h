@@ -0,0 +1,59 @@
+/*
+ * SimpleOS_msp430.h
+ *
+ *  SimpleOS port for the msp430g2553, see SimpleOS_port.h.
+ *  The tick is the Timer0 CCR0 interrupt.  A switch between
+ *  ticks sets the CCR1 flag, on the TIMER0_A1 vector, so it
+ *  can't be mixed up with a tick.
+ *
+ */
+
+#ifndef SIMPLEOS_SIMPLEOS_MSP430_H_
+#define SIMPLEOS_SIMPLEOS_MSP430_H_
+
+#include <msp430g2553.h>
+
+
+////////////////////////////////////
+//Timer vectors.  The tick is CCR0.  A switch
+//between ticks sets the CCR1 flag by hand.
+//TACCR1 is 0xFFFF so it never matches in up
+//mode, TACCR0 has to be less than that.  Leave
+//TAIE and CCR2 off, they share the vector.
+#define SIMPLEOS_TIMER_VECTOR       TIMER0_A0_VECTOR
+#define SIMPLEOS_SWITCH_VECTOR      TIMER0_A1_VECTOR
+
+////////////////////////////////////
+//Idle.  LPM0 keeps SMCLK on for the timer
+#define SIMPLEOS_IDLE_LPM_BITS      LPM0_bits
+
+////////////////////////////////////
+//Profiling.  Set SIMPLEOS_PROFILE to 1 to count
+//the cycles in the SimpleOS_ISR with TimerA1
+//on SMCLK, see SimpleOS_getSwitchCycles().
+#ifndef SIMPLEOS_PROFILE
+#define SIMPLEOS_PROFILE            0
+#endif
+
+#define SIMPLEOS_PROFILE_TIMER_START()  (TA1CTL = TASSEL_2 | MC_2 | TACLR)
+
+
+////////////////////////////////////
+//Port
+#define SIMPLEOS_DISABLE()          __bic_SR_register(GIE)
+#define SIMPLEOS_ENABLE()           __bis_SR_register(GIE)
+#define SIMPLEOS_SWITCH_INIT()      do { TACCR1 = 0xFFFF; TACCTL1 = CCIE; } while (0)
+#define SIMPLEOS_PEND_SWITCH()      (TACCTL1 |= CCIFG)
+#define SIMPLEOS_CLEAR_SWITCH()     (TACCTL1 &= ~CCIFG)     //CCR1 doesn't clear itself
+
+//the isr clears the low power bits on the way out
+#define SIMPLEOS_IDLE()                                         \
+    do {                                                        \
+        __bis_SR_register(SIMPLEOS_IDLE_LPM_BITS | GIE);        \
+        __no_operation();                                       \
+        __bic_SR_register(GIE);                                 \
+    } while (0)
+
+
+
+#endif /* SIMPLEOS_SIMPLEOS_MSP430_H_ */
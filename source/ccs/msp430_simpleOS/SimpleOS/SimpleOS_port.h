@@ -0,0 +1,36 @@
+/*
+ * SimpleOS_port.h
+ *
+ *  Picks the port, the parts of SimpleOS that depend
+ *  on the cpu.  The msp430 port is the default, define
+ *  SIMPLEOS_PORT_POSIX to build the host port in
+ *  source/host/simpleOS_posix.
+ *
+ *  A port header defines:
+ *  SIMPLEOS_DISABLE(), SIMPLEOS_ENABLE() - tick interrupt off / on
+ *  SIMPLEOS_SWITCH_INIT() - set up the switch interrupt, at launch
+ *  SIMPLEOS_PEND_SWITCH() - run the SimpleOS_ISR when enabled,
+ *      on an interrupt of its own, not the tick
+ *  SIMPLEOS_CLEAR_SWITCH() - drop a pended switch, the
+ *      scheduler is doing it
+ *  SIMPLEOS_IDLE() - enable, sleep until the isr has run, disable
+ *
+ *  It can also set STACK_SIZE and STACK_MIN for Task.h.
+ *  The port's .c file has SimpleOS_start(), SimpleOS_ISR(),
+ *  SimpleOS_switchISR(),
+ *  SimpleOS_EnterCritical(), SimpleOS_ExitCritical() and
+ *  Task_initFrame().  The tick sets gTickPending before it
+ *  calls the scheduler, the switch doesn't.  Everything
+ *  else is shared.
+ */
+
+#ifndef SIMPLEOS_SIMPLEOS_PORT_H_
+#define SIMPLEOS_SIMPLEOS_PORT_H_
+
+#if defined(SIMPLEOS_PORT_POSIX)
+#include "SimpleOS_posix.h"
+#else
+#include "SimpleOS_msp430.h"
+#endif
+
+#endif /* SIMPLEOS_SIMPLEOS_PORT_H_ */
@@ -8,6 +8,35 @@
  *  General approach:
  *  Allocate array of task control blocks in initialization.
  *  Append tasks as active as needed using a call to append task.
+ *
+ *  Ready lists:
+ *  Each priority has a circular list of ready tasks.  ReadyList[p]
+ *  points to the task that ran last at that priority and ReadySet
+ *  has bit p set if the list is not empty.  The highest priority
+ *  ready task is the lowest set bit, found with a lookup table, so
+ *  picking the next task takes the same time with any number of
+ *  tasks.  Tasks at the same priority take turns.
+ *
+ *  Sleep list:
+ *  Sleeping tasks are kept in a list sorted by wake time.  Each
+ *  entry holds the ticks after the one in front of it, so the
+ *  tick only counts down the head of the list.
+ *
+ *  Blocked tasks are not in any list, blockPt points to the
+ *  semaphore they're waiting on.
+ *
+ *  Stacks:
+ *  Each task gets a stack buffer from the caller, so stacks can
+ *  be sized for what the task does.  The stack is painted with
+ *  STACK_PAINT, the high water mark is the painted words at the
+ *  bottom that have been written over.  The bottom word is the
+ *  canary, it's checked on every switch.
+ *
+ *  Free list:
+ *  Task blocks that aren't in use are kept in a free list, linked
+ *  through next, so allocating and freeing don't search the array.
+ *  A task that returns from it's function lands in the exit function
+ *  set with Task_setExit(), so the block goes back on the free list.
  */
 
 #include <stdio.h>
@@ -24,6 +53,26 @@
 //Task Array and pointer to current task
 TaskStruct TaskList[MAXTHREADS];
 TaskStruct* pTaskHead;
+TaskStruct* FreeList = NULL;            //unused task blocks
+
+void (*TaskExitPtr)(void) = NULL;       //task functions return here
+
+///////////////////////////////////////////
+//Ready lists, one per priority, and the
+//bit set of priorities with ready tasks
+TaskStruct* ReadyList[NUM_PRIORITIES];
+uint8_t ReadySet = 0x00;
+
+///////////////////////////////////////////
+//Sleep list, sorted by wake time
+TaskStruct* SleepHead = NULL;
+
+//lowest set bit in a nibble, 1 based
+//so 0 means no bit set
+static const uint8_t ReadyLowBitLkup[16] =
+{
+    0, 1, 2, 1, 3, 1, 2, 1, 4, 1, 2, 1, 3, 1, 2, 1
+};
 
 
 //////////////////////////////////////////////////////////
@@ -31,81 +80,181 @@ TaskStruct* pTaskHead;
 //Initializes all tasks in the allocated array of  task
 //blocks to inactivec with no functions to run.
 //Allocates one task as the default task
-TaskStruct* Task_init(void (*functionPtr)(void))
+//stack, stackSize - stack buffer for the task, size in words
+//Returns the default task, NULL if the stack is
+//smaller than STACK_MIN, same as Task_appendTask().
+//The task blocks are cleared either way.
+TaskStruct* Task_init(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize)
 {
     TaskStruct* myTask;
-    pTaskHead = TaskList;
+    pTaskHead = NULL;
+    FreeList = NULL;
 
-    for (int i = 0 ; i < MAXTHREADS ; i++)
+    //build the free list backwards so index 0 goes first
+    for (int i = MAXTHREADS - 1 ; i >= 0 ; i--)
     {
         TaskList[i].sp = NULL;
-        TaskList[i].next = NULL;
-        memset(TaskList[i].stack, 0x00, STACK_SIZE);
+        TaskList[i].next = FreeList;
+        FreeList = &TaskList[i];
+        TaskList[i].stack = NULL;
+        TaskList[i].stackSize = 0;
+        TaskList[i].overflow = 0;
         TaskList[i].index = i;
         TaskList[i].alive = 0;
+        TaskList[i].nextReady = NULL;
+        TaskList[i].nextSleep = NULL;
+        TaskList[i].blockPt = NULL;
+        TaskList[i].sleep = 0;
+        TaskList[i].priority = 0;
+        TaskList[i].basePriority = 0;
+        TaskList[i].mutexHeld = 0;
     }
 
+    SleepHead = NULL;
+
+    for (int i = 0 ; i < NUM_PRIORITIES ; i++)
+        ReadyList[i] = NULL;
+
+    ReadySet = 0x00;
+
+    if ((stack == NULL) || (stackSize < STACK_MIN))
+        return NULL;
+
     //Allocate the default task and initialize the task stack
     myTask = Task_allocateTask();
-    Task_initStack(myTask, functionPtr);
+    pTaskHead = myTask;
+    Task_initStack(myTask, functionPtr, stack, stackSize);
 
-    return pTaskHead;
+    //start it off ready to run
+    myTask->priority = (priority < NUM_PRIORITIES) ? priority : (NUM_PRIORITIES - 1);
+    myTask->basePriority = myTask->priority;
+    Task_setReady(myTask);
+
+    return myTask;
 }
 
 ///////////////////////////////////////////////////////
 //Task_appendTask
 //Add a new task to the linked list of TaskStructs.
 //Allocate a new task, link the new task, set
-//the function to run pointer, return the task head.
-TaskStruct* Task_appendTask(void (*functionPtr)(void))
+//the function to run pointer, add it to the ready
+//list for it's priority, return the new task.
+//If there's no free task block or the stack is
+//smaller than STACK_MIN, the task is not added
+//and it returns NULL.
+//Call with interrupts disabled.
+TaskStruct* Task_appendTask(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize)
 {
     TaskStruct* ptr = pTaskHead;                //head
-    TaskStruct* myTask = Task_allocateTask();   //pointer to new task
+    TaskStruct* myTask;                         //pointer to new task
 
-    //jump to the end of the list...
-    while (ptr->next != NULL)
-        ptr = ptr->next;
+    if ((stack == NULL) || (stackSize < STACK_MIN))
+        return NULL;
 
-    //link the new node and configure
-    ptr->next = myTask;
+    myTask = Task_allocateTask();
+
+    if (myTask == NULL)
+        return NULL;
+
+    //link the new node at the end of the list
     myTask->next = NULL;
 
+    if (ptr == NULL)
+        pTaskHead = myTask;             //all the others exited
+
+    else
+    {
+        while (ptr->next != NULL)
+            ptr = ptr->next;
+
+        ptr->next = myTask;
+    }
+
     //init the stack and set the task function
-    Task_initStack(myTask, functionPtr);
+    Task_initStack(myTask, functionPtr, stack, stackSize);
 
-    return pTaskHead;
+    myTask->priority = (priority < NUM_PRIORITIES) ? priority : (NUM_PRIORITIES - 1);
+    myTask->basePriority = myTask->priority;
+    Task_setReady(myTask);
+
+    return myTask;
 }
 
 //////////////////////////////////////////////////
 //Task_allocateTask
-//Find the first inactive task in the TaskList,
+//Take the first task block off the free list,
 //set it to active, initialize it.
 //Return the address of the allocated task.  If
 //none are available, return NULL.
 //
 TaskStruct* Task_allocateTask(void)
 {
-    TaskStruct* ptr = NULL;
-    for (int i = 0 ; i < MAXTHREADS ; i++)
+    TaskStruct* ptr = FreeList;
+
+    if (ptr != NULL)
     {
-        if(!(TaskList[i].alive))
-        {
-            ptr = &TaskList[i];             //set the return address
-            TaskList[i].alive = 1;
-            TaskList[i].index = i;
-            TaskList[i].next = NULL;
-            TaskList[i].sp = NULL;
-            memset(TaskList[i].stack, 0x00, STACK_SIZE);
-            //break out of loop
-            i = MAXTHREADS;
-            break;
-        }
+        FreeList = ptr->next;
+
+        ptr->alive = 1;
+        ptr->next = NULL;
+        ptr->nextReady = NULL;
+        ptr->nextSleep = NULL;
+        ptr->blockPt = NULL;
+        ptr->sleep = 0;
+        ptr->sp = NULL;
+        ptr->stack = NULL;
+        ptr->stackSize = 0;
+        ptr->overflow = 0;
+        ptr->mutexHeld = 0;
     }
 
     return ptr;     //returns NULL if cannot allocate
 }
 
 
+//////////////////////////////////////////////////
+//Task_freeTask
+//Take a task out of the task list and put the
+//block back on the free list.  The task has to
+//be out of the ready and sleep lists already.
+//The stack is left alone, the task may still be
+//running on it until the next switch.
+//Call with interrupts disabled.
+//
+void Task_freeTask(TaskStruct* task)
+{
+    TaskStruct* ptr = pTaskHead;
+
+    if (ptr == task)
+        pTaskHead = task->next;
+
+    else
+    {
+        while ((ptr != NULL) && (ptr->next != task))
+            ptr = ptr->next;
+
+        if (ptr != NULL)
+            ptr->next = task->next;
+    }
+
+    task->alive = 0;
+    task->blockPt = NULL;
+    task->next = FreeList;
+    FreeList = task;
+}
+
+
+//////////////////////////////////////////////////
+//Task_setExit
+//Function a task lands in if it's function
+//returns.  Set it before adding tasks.
+//
+void Task_setExit(void (*exitPtr)(void))
+{
+    TaskExitPtr = exitPtr;
+}
+
+
 /////////////////////////////////////////////
 //Traverse the list of active task blocks
 //counting the number of active linked tasks.
@@ -114,7 +263,7 @@ uint8_t Task_getNumTasks(void)
     uint8_t count = 0x00;
     TaskStruct* ptr = pTaskHead;
 
-    if (!(ptr->alive))
+    if ((ptr == NULL) || !(ptr->alive))
         return 0;
 
     while (ptr->next != NULL)
@@ -128,37 +277,19 @@ uint8_t Task_getNumTasks(void)
 
 /////////////////////////////////////////////////////////
 //Init the stack
-//set the function to run in a position such that after
-//pushes/pops in the OS start / context switch routines, it
-//lands on the function to run.
-void Task_initStack(TaskStruct* task, void (*functionPtr)(void))
-{
-    //set the function pointer address.
-    task->stack[STACK_SIZE-5] = (int16_t)functionPtr;
-
-    /////////////////////////////////////////////////
-    task->stack[STACK_SIZE-1] = (0x1000);   // R0 - PC
-    task->stack[STACK_SIZE-2] = (0x0110);   // R1 - SP - address of SP holds contents of next instruction when returning from a function
-    task->stack[STACK_SIZE-3] = (0x0220);   // R2 - SR - holds the GIE bit
-    task->stack[STACK_SIZE-4] = (0x0330);   // R3 - Leave this alone.
-    task->stack[STACK_SIZE-6] = (0x0EE0);   // R14 - working reg
-    task->stack[STACK_SIZE-7] = (0x0DD0);   // R13 -  ....
-    task->stack[STACK_SIZE-8] = (0x0CC0);   // R12
-    task->stack[STACK_SIZE-9] = (0x0BB0);   // R11
-    task->stack[STACK_SIZE-10] = (0x0AA0);  // R10
-    task->stack[STACK_SIZE-11] = (0x0990);  // R9
-    task->stack[STACK_SIZE-12] = (0x0880);  // R8
-    task->stack[STACK_SIZE-13] = (0x0770);  // R7
-    task->stack[STACK_SIZE-14] = (0x0660);  // R6 - working reg
-    task->stack[STACK_SIZE-15] = (0x0550);  // R5 - R5 is the last pop/push
-    task->stack[STACK_SIZE-16] = (0x0440);  // R4 - R4 - used for args.
-
-    //set the initial stack pointer location.  This should be set
-    //to allow push/pop operations to not overflow the stack.
-    //pop - increment the SP, push - decrement the sp.
-    //stack - 16 works with the pop/push routines in initial setup
-    //and the context switch.
-    task->sp = &task->stack[STACK_SIZE - 16]; //SP
+//Paint the stack so the high water mark can be found,
+//then the port sets up the frame the first switch to
+//the task pops, see Task_initFrame().
+void Task_initStack(TaskStruct* task, void (*functionPtr)(void), int16_t* stack, uint16_t stackSize)
+{
+    task->stack = stack;
+    task->stackSize = stackSize;
+    task->overflow = 0;
+
+    for (uint16_t i = 0 ; i < stackSize ; i++)
+        stack[i] = (int16_t)STACK_PAINT;
+
+    Task_initFrame(task, functionPtr, TaskExitPtr);
 }
 
 TaskStruct* Task_getHead(void)
@@ -166,7 +297,330 @@ TaskStruct* Task_getHead(void)
     return pTaskHead;
 }
 
+/////////////////////////////////////////////////
+//Task_getTask
+//Task block at index, NULL if the index is bad
+//or the task is not allocated.
+TaskStruct* Task_getTask(uint8_t index)
+{
+    if ((index < MAXTHREADS) && (TaskList[index].alive))
+        return &TaskList[index];
 
+    return NULL;
+}
+
+
+/////////////////////////////////////////////////
+//Task_checkStack
+//Check the stack of the task the isr interrupted.
+//The isr saves the live SP in sp before it calls
+//the scheduler.  It's overflowed if there isn't
+//room below that SP for the STACK_CHECK_MARGIN words
+//the switch still pushes, or the canary at the
+//bottom got written over.  Sets and returns the
+//overflow flag.
+uint8_t Task_checkStack(TaskStruct* task)
+{
+    if ((task->sp < task->stack + STACK_CHECK_MARGIN) || (task->stack[0] != (int16_t)STACK_PAINT))
+        task->overflow = 1;
+
+    return task->overflow;
+}
 
 
+/////////////////////////////////////////////////
+//Task_getStackUsed
+//High water mark, the most words of the stack
+//the task has used.  Counts the painted words
+//from the bottom up.
+uint16_t Task_getStackUsed(TaskStruct* task)
+{
+    uint16_t unused = 0;
+
+    while ((unused < task->stackSize) && (task->stack[unused] == (int16_t)STACK_PAINT))
+        unused++;
+
+    return task->stackSize - unused;
+}
+
+
+
+/////////////////////////////////////////////////
+//Task_setReady
+//Add a task to the ready list for it's priority.
+//It goes in right after the task that ran last,
+//so it runs next time that priority comes up.
+//Call with interrupts disabled.
+void Task_setReady(TaskStruct* task)
+{
+    uint8_t p = task->priority;
+
+    if (ReadyList[p] == NULL)
+    {
+        task->nextReady = task;         //only one, points to itself
+        ReadyList[p] = task;
+        ReadySet |= (1 << p);
+    }
+
+    else
+    {
+        task->nextReady = ReadyList[p]->nextReady;
+        ReadyList[p]->nextReady = task;
+    }
+}
+
+
+/////////////////////////////////////////////////
+//Task_clearReady
+//Take a task out of the ready list for it's
+//priority.  If it was the last one to run, the
+//one after it is up next.  Clear the ready bit
+//if the list is empty.  Does nothing if the task
+//is not in the list.
+//Call with interrupts disabled.
+void Task_clearReady(TaskStruct* task)
+{
+    uint8_t p = task->priority;
+    TaskStruct* prev = ReadyList[p];
+
+    if (prev == NULL)
+        return;
+
+    //find the one in front of it
+    while (prev->nextReady != task)
+    {
+        prev = prev->nextReady;
 
+        if (prev == ReadyList[p])
+            return;                     //went all the way around
+    }
+
+    if (prev == task)
+    {
+        ReadyList[p] = NULL;            //it was the only one
+        ReadySet &=~ (1 << p);
+    }
+
+    else
+    {
+        prev->nextReady = task->nextReady;
+
+        if (ReadyList[p] == task)
+            ReadyList[p] = task->nextReady;
+    }
+
+    task->nextReady = NULL;
+}
+
+
+/////////////////////////////////////////////////
+//Task_getHighestReady
+//Last task to run at the highest priority with
+//a ready task.  Two steps with the lookup table.
+//Returns NULL if nothing is ready.
+TaskStruct* Task_getHighestReady(void)
+{
+    uint8_t p = 0;
+    uint8_t ready = ReadySet;
+
+    if (!ready)
+        return NULL;
+
+    if (!(ready & 0x0F))
+    {
+        ready >>= 4;
+        p = 4;
+    }
+
+    p += ReadyLowBitLkup[ready & 0x0F] - 1;
+
+    return ReadyList[p];
+}
+
+
+/////////////////////////////////////////////////
+//Task_getNextReady
+//Task to run after current's timeslice.  If
+//current is at the highest ready priority, move
+//on to the next one at that priority (round robin).
+//Otherwise run the highest priority task, picking
+//up with the one that ran last at that priority.
+//Returns current if nothing is ready.
+//Call with interrupts disabled.
+TaskStruct* Task_getNextReady(TaskStruct* current)
+{
+    TaskStruct* task = Task_getHighestReady();
+
+    if (task == NULL)
+        return current;
+
+    //timeslice is up, next one in line
+    if (task == current)
+    {
+        task = task->nextReady;
+        ReadyList[task->priority] = task;
+    }
+
+    return task;
+}
+
+
+/////////////////////////////////////////////////
+//Task_isReady
+//Returns 1 if the task is in a ready list, 0 if
+//it's sleeping or blocked.
+uint8_t Task_isReady(TaskStruct* task)
+{
+    return (task->nextReady != NULL);
+}
+
+
+/////////////////////////////////////////////////
+//Task_setPriority
+//Change the priority of a task.  If it's ready
+//it moves to the ready list for the new priority,
+//it goes next in line there.  The base priority
+//is left alone.
+//Call with interrupts disabled.
+void Task_setPriority(TaskStruct* task, uint8_t priority)
+{
+    if (priority >= NUM_PRIORITIES)
+        priority = NUM_PRIORITIES - 1;
+
+    if (task->priority == priority)
+        return;
+
+    if (Task_isReady(task))
+    {
+        Task_clearReady(task);
+        task->priority = priority;
+        Task_setReady(task);
+    }
+
+    else
+        task->priority = priority;
+}
+
+
+/////////////////////////////////////////////////
+//Task_sleep
+//Put a task in the sleep list so it's made ready
+//after ticks.  Walk the list subtracting each
+//delta until we find where it goes, then take
+//it's delta off the one behind it.  Take the task
+//out of the ready list first.
+//Call with interrupts disabled.
+void Task_sleep(TaskStruct* task, uint32_t ticks)
+{
+    TaskStruct* prev = NULL;
+    TaskStruct* curr = SleepHead;
+
+    //0 would never get counted down
+    if (!ticks)
+        ticks = 1;
+
+    //tasks that wake on the same tick wake in
+    //the order they went to sleep
+    while ((curr != NULL) && (curr->sleep <= ticks))
+    {
+        ticks -= curr->sleep;
+        prev = curr;
+        curr = curr->nextSleep;
+    }
+
+    task->sleep = ticks;
+    task->nextSleep = curr;
+
+    if (curr != NULL)
+        curr->sleep -= ticks;
+
+    if (prev == NULL)
+        SleepHead = task;
+    else
+        prev->nextSleep = task;
+}
+
+
+/////////////////////////////////////////////////
+//Task_sleepRemove
+//Take a task out of the sleep list and give
+//it's remaining ticks to the one behind it.  For
+//a task woken up before it's timeout.  Does
+//nothing if the task is not in the list.
+//Call with interrupts disabled.
+void Task_sleepRemove(TaskStruct* task)
+{
+    TaskStruct* prev = NULL;
+    TaskStruct* curr = SleepHead;
+
+    while ((curr != NULL) && (curr != task))
+    {
+        prev = curr;
+        curr = curr->nextSleep;
+    }
+
+    if (curr == NULL)
+        return;
+
+    if (task->nextSleep != NULL)
+        task->nextSleep->sleep += task->sleep;
+
+    if (prev == NULL)
+        SleepHead = task->nextSleep;
+    else
+        prev->nextSleep = task->nextSleep;
+
+    task->nextSleep = NULL;
+    task->sleep = 0;
+}
+
+
+/////////////////////////////////////////////////
+//Task_tick
+//Called every tick.  Count down the head of the
+//sleep list and make every task that's done
+//sleeping ready.
+//Call with interrupts disabled.
+void Task_tick(void)
+{
+    TaskStruct* task;
+
+    if (SleepHead == NULL)
+        return;
+
+    SleepHead->sleep--;
+
+    while ((SleepHead != NULL) && (SleepHead->sleep == 0))
+    {
+        task = SleepHead;
+        SleepHead = task->nextSleep;
+        task->nextSleep = NULL;
+
+        Task_setReady(task);
+    }
+}
+
+
+/////////////////////////////////////////////////
+//Task_getBlocked
+//Highest priority task blocked on signal (a
+//semaphore, a queue, a mutex, or a task for SimpleOS_join),
+//the lowest index wins a tie.  Tasks that timed
+//out are ready but still have blockPt set until
+//they run, they're skipped.  Returns NULL if no
+//task is waiting on it.
+TaskStruct* Task_getBlocked(void* signal)
+{
+    TaskStruct* task = NULL;
+
+    for (int i = 0 ; i < MAXTHREADS ; i++)
+    {
+        if ((TaskList[i].alive) && (TaskList[i].blockPt == signal) && !Task_isReady(&TaskList[i]))
+        {
+            if ((task == NULL) || (TaskList[i].priority < task->priority))
+                task = &TaskList[i];
+        }
+    }
+
+    return task;
+}
@@ -19,38 +19,92 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "SimpleOS_port.h"      //the port can change the stack sizes
+
 
 #define MAXTHREADS      4
-#define STACK_SIZE     48
+#ifndef STACK_SIZE
+#define STACK_SIZE     48       //default stack size in words
+#endif
+#ifndef STACK_FRAME
+#define STACK_FRAME    15       //exit return address, PC, SR, R15-R4
+#endif
+#ifndef STACK_MIN
+#define STACK_MIN      24       //smallest stack, switch frame + a few calls
+#endif
+#ifndef STACK_CHECK_MARGIN
+#define STACK_CHECK_MARGIN  7   //R10-R4, pushed after the check on a switch
+#endif
+#define STACK_PAINT    0xA5A5   //unused stack words
+#define NUM_PRIORITIES  8       //0 is the highest, 8 max (one byte ready set)
 
 
 //////////////////////////////////////////////////////
 //Task Control Block
 //sp -    Stack Pointer - stores SP when task not running,
 //        mapped to the task stack.
-//next -  pointer to the next task to run.
-//stack - task stack.  when task is running, CPU SP is
-//        mapped here.  Push/pop operates on this stack.
+//next -  pointer to the next task in the task list.
+//nextReady - next ready task at the same priority.
+//stack - task stack, passed in by the caller.  when
+//        task is running, CPU SP is mapped here.  Push/pop
+//        operates on this stack.  stack[0] is the bottom.
+//stackSize - words in the stack.
+//overflow - set if the stack was found overflowed on a switch.
+//priority - 0 is the highest.
+//basePriority - priority it was added with, priority can be
+//        raised above it while holding a mutex.
+//mutexHeld - mutexes it has locked.
+//nextSleep, sleep - sleep list, sleep is the ticks
+//        after the task in front of it.
+//blockPt - semaphore or task the task is waiting on, NULL if none.
 //
 struct taskStruct
 {
     int16_t* sp;                        //stack pointer - needs to be first
     struct taskStruct* next;             //pointer to next task
-    int16_t stack[STACK_SIZE];          //task stack
+    struct taskStruct* nextReady;       //ready list, circular, NULL if not ready
+    struct taskStruct* nextSleep;       //sleep list, NULL at the end
+    void* blockPt;                      //semaphore or task it's blocked on
+    uint32_t sleep;                     //ticks to sleep, relative to the task in front
+    int16_t* stack;                     //task stack, stack[0] is the bottom
+    uint16_t stackSize;                 //size in words
     uint8_t index;                      //index in the task list
     uint8_t alive;                      //allocated / not allocated
+    uint8_t priority;                   //0 - NUM_PRIORITIES-1, 0 is highest
+    uint8_t basePriority;               //priority without inheritance
+    uint8_t mutexHeld;                  //mutexes locked
+    uint8_t overflow;                   //stack overflow seen
 };
 
 typedef struct taskStruct TaskStruct;
 
 
-TaskStruct* Task_init(void (*functionPtr)(void));
-TaskStruct* Task_appendTask(void (*functionPtr)(void));
+TaskStruct* Task_init(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize);
+TaskStruct* Task_appendTask(void (*functionPtr)(void), uint8_t priority, int16_t* stack, uint16_t stackSize);
 TaskStruct* Task_allocateTask(void);
+void Task_freeTask(TaskStruct* task);
+void Task_setExit(void (*exitPtr)(void));
 
 uint8_t Task_getNumTasks(void);
-void Task_initStack(TaskStruct* task, void (*functionPtr)(void));
+void Task_initStack(TaskStruct* task, void (*functionPtr)(void), int16_t* stack, uint16_t stackSize);
+void Task_initFrame(TaskStruct* task, void (*functionPtr)(void), void (*exitPtr)(void));     //in the port
 TaskStruct* Task_getHead(void);
+TaskStruct* Task_getTask(uint8_t index);
+
+uint8_t Task_checkStack(TaskStruct* task);
+uint16_t Task_getStackUsed(TaskStruct* task);
+
+void Task_setReady(TaskStruct* task);
+void Task_clearReady(TaskStruct* task);
+TaskStruct* Task_getHighestReady(void);
+TaskStruct* Task_getNextReady(TaskStruct* current);
+uint8_t Task_isReady(TaskStruct* task);
+void Task_setPriority(TaskStruct* task, uint8_t priority);
+
+void Task_sleep(TaskStruct* task, uint32_t ticks);
+void Task_sleepRemove(TaskStruct* task);
+void Task_tick(void);
+TaskStruct* Task_getBlocked(void* signal);
 
 
 
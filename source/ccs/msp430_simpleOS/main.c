@@ -5,12 +5,13 @@
  *
  * The goal of this project is to create a super simple
  * opperating system to run on the MSP430G2553.  It will include
- * context switching, round robin scheduler, etc.  The concepts
+ * context switching, priority scheduler (round robin at the same
+ * priority), etc.  The concepts
  * used in this project follow along with information presented in an
  * online embedded systems class for the ARM Cortex processor
  * (see edx.org).  The main differences include:
  * - assembly instruction set for the MSP430.
- * - stack is a member of the task block struct.
+ * - stacks are passed in with each task, sized for the task.
  * - statically allocated array of task blocks with option to add as
  *   many as the memory allows.
  * - others, but not sure since the project is not completed.
@@ -31,11 +32,12 @@
 #include <string.h>
 
 #include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
 
 
 //prototypes
 void GPIO_init(void);
-void TimerA_init(void (*functionPtr)(void));        //pass isr handler ptr
+void TimerA_init(void);
 void LED_RED_TOGGLE(void);
 void LED_GREEN_TOGGLE(void);
 
@@ -46,11 +48,6 @@ void TaskFunction4(void);
 
 
 
-////////////////////////////////////////////////
-//Timer ISR Handler
-void (*gTimerISRHandler)(void);
-void TimerISR_DefaultHandler(void);
-
 ///////////////////////////////////////////////
 //Task Counters
 volatile uint32_t counter1 = 0x00;
@@ -59,11 +56,20 @@ volatile uint32_t counter3 = 0x00;
 volatile uint32_t counter4 = 0x00;
 
 ////////////////////////////////////////////////
-//flags
-int16_t* task1Flag = 0;
-int16_t* task2Flag = 0;
-int16_t* task3Flag = 0;
-int16_t* task4Flag = 0;
+//flags - semaphore counts
+int16_t task1Flag = 0;
+int16_t task2Flag = 0;
+int16_t task3Flag = 0;
+int16_t task4Flag = 0;
+
+////////////////////////////////////////////////
+//Thread stacks.  Task 1 calls two OS functions
+//in a row, the rest are small.  Check the sizes
+//with SimpleOS_getStackUsed().
+int16_t stack1[STACK_SIZE];
+int16_t stack2[40];
+int16_t stack3[40];
+int16_t stack4[40];
 
 
 //main program
@@ -75,19 +81,23 @@ int main(void)
     //disable interupts
     __bic_SR_register(GIE);
 
-    //Pass Timer handler into the timer config as function to run on timeout
+    //SimpleOS_ISR is the timer isr, see SIMPLEOS_TIMER_VECTOR
     GPIO_init();
-    TimerA_init(&SimpleOS_ISR);
+    TimerA_init();
 
-    //Configure the tasks and start the OS
-    SimpleOS_init(TaskFunction1);
-    SimpleOS_addThread(TaskFunction2);
-    SimpleOS_addThread(TaskFunction3);
-    SimpleOS_addThread(TaskFunction4);
+    //Configure the tasks and start the OS.  Task 2
+    //waits on task 1, so it gets the highest priority
+    //and runs as soon as it's signaled.  Tasks 3 and
+    //4 take turns at the lowest.
+    SimpleOS_init(TaskFunction1, 1, stack1, STACK_SIZE);
+    SimpleOS_addThread(TaskFunction2, 0, stack2, 40);
+    SimpleOS_addThread(TaskFunction3, 2, stack3, 40);
+    SimpleOS_addThread(TaskFunction4, 2, stack4, 40);
 
     SimpleOS_launch();
 
-    //Should never make it here
+    //Should never make it here, only if the stack
+    //passed to SimpleOS_init() was too small
     while(1){};
 
     return 0;
@@ -121,21 +131,17 @@ void GPIO_init(void)
 //TimerA_init
 //Set the CPU speed to 16mhz and configure the timer
 //to timeout and interrupt at 100hz, 10ms timeslices.
-//NOTE:  Keep an eye on the timer reload value.  Although
-//2000 will result in 1ms time slice, the counter keeps running
-//during the ISR (strange).  If it overflows, it will generate
-//another interrupt right on exit.  This will mess up the context
-//switch.
+//NOTE:  Keep an eye on the timer reload value.  The
+//counter keeps running during the ISR.  If the ISR takes
+//longer than the timeslice, it will generate another
+//interrupt right on exit.
 //
-//Argument: Pointer to function to run in the ISR
+//The CCR0 interrupt is the tick, SimpleOS_ISR is on
+//that vector.  SimpleOS_launch() sets up CCR1 for
+//switches between ticks, keep TACCR0 below 0xFFFF.
 //
-void TimerA_init(void (*functionPtr)(void))
+void TimerA_init(void)
 {
-    if (functionPtr != NULL)
-        gTimerISRHandler = functionPtr;
-    else
-        gTimerISRHandler = &TimerISR_DefaultHandler;
-
     BCSCTL1 = CALBC1_16MHZ;
     DCOCTL = CALDCO_16MHZ;
 
@@ -145,7 +151,6 @@ void TimerA_init(void (*functionPtr)(void))
     TACTL |= BIT7;      //use prescaler 8
     TACTL |= BIT6;
     TACTL |= BIT4;      //count up to TACCR0(set below)
-    TACTL |= BIT1;      //enable the interrupt
     TACTL &=~ BIT0;     //clear all pending interrupts
 
     //set the countup value for 1ms delay
@@ -154,6 +159,7 @@ void TimerA_init(void (*functionPtr)(void))
     ///////////////////////////////////////////////////
     //This value sets the timeout frequency.
     //For a 16mhz clock, use the following values:
+    //250us = 500;
     //1ms = 2000;
     //2ms = 4000;
     //4ms = 8000;
@@ -185,27 +191,6 @@ void LED_GREEN_TOGGLE(void)
     P1OUT ^= BIT6;
 }
 
-////////////////////////////////////////////////////////////
-//Timer A - ISR for TIMER0_A0_VECTOR
-//Format used with the GNU compiler
-__attribute__((interrupt(TIMER0_A0_VECTOR))) void Timer_A(void)
-{
-    TACTL &=~ BIT0;     //clear the timer interrupt flag
-    (*gTimerISRHandler)();
-}
-
-/////////////////////////////////////////////
-//Default Timer ISR
-//This function is set to the TimerISR when
-//initialization routine passes NULL as target ISR.
-//
-void TimerISR_DefaultHandler(void)
-{
-    TACTL &=~ BIT0;     //clear the timer interrupt flag
-    //do something
-}
-
-
 
 ///////////////////////////////////////////
 //TaskFunction1
@@ -226,13 +211,13 @@ void TaskFunction1(void)
 
 //////////////////////////////////////////////
 //TaskFunction2
+//Blocked until task 1 signals, no delay needed
 void TaskFunction2(void)
 {
     while (1)
     {
-        SimpleOS_semaphoreWait(task2Flag);
+        SimpleOS_semaphoreWait(&task2Flag);
         LED_GREEN_TOGGLE();
-        SimpleOS_delay(100);
     }
 }
 
@@ -33,7 +33,7 @@ static volatile int TimeDelay;
 
 //prototypes
 void delay_ms(volatile int ticks);
-void TimeDelay_Decrement(void);
+void TimeDelay_Decrement(uint16_t ticks);
 void GPIO_init(void);
 void TimerA_init(void);
 void Interrupt_init(void);
@@ -61,8 +61,8 @@ int main(void)
 	/////////////////////////////////////////
 	//configure the scheduler with some tasks
 	Task_Init();
-	Task_AddTask(LedRed_Toggle, 500, 0);
-	Task_AddTask(LedGreen_Toggle, 500, 1);
+	Task_AddTask("red", LedRed_Toggle, 500, TASK_ID_RED);
+	Task_AddTask("green", LedGreen_Toggle, 500, TASK_ID_GREEN);
 
 	//start the scheduler
 	Task_StartScheduler();
@@ -89,12 +89,18 @@ void delay_ms(volatile int ticks)
 
 
 /////////////////////////////////////////
-//Function called from the TimerA ISR
-void TimeDelay_Decrement(void)
+//Function called from the TimerA ISR with
+//the ticks since the last one, 1 unless
+//tickless
+void TimeDelay_Decrement(uint16_t ticks)
 {
-	if (TimeDelay != 0x00)
+	if (TimeDelay > (int)ticks)
 	{
-		TimeDelay--;
+		TimeDelay -= ticks;
+	}
+	else
+	{
+		TimeDelay = 0;
 	}
 }
 
@@ -210,12 +216,27 @@ void LedGreen_Clear(void)
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer_A(void)
 {
+#if TASK_TICKLESS
+	uint32_t start;
+#endif
+
 	//clear the timer interrupt
 	TACTL &=~ BIT0;
 
-	TimeDelay_Decrement();
+#if TASK_TICKLESS
+	start = Task_GetTickCount();
+
+	Task_TimerISRHandler();		//task table
+
+	//one interrupt is the whole period the
+	//tasker programmed, not one tick
+	TimeDelay_Decrement(Task_GetTickCount() - start);
+#else
+	TimeDelay_Decrement(1);
 
 	Task_TimerISRHandler();		//task table
+#endif
+	TASK_WAKE_ON_EXIT();		//run the scheduler if tickless
 }
 
 
@@ -0,0 +1,36 @@
+/*
+ * task_config.h
+ *
+ *  Tasker settings for msp430_task1.  No names
+ *  or messages, just two tasks toggling leds.
+ *  See common/task/task.h for the options.
+ *
+ */
+
+#ifndef TASK_CONFIG_H_
+#define TASK_CONFIG_H_
+
+#define TASK_MAX_TASK		2			//red, green
+#define TASK_USE_NAMES		0
+#define TASK_USE_MESSAGES	0
+
+//with tickless the Timer_A isr in main.c passes
+//TimeDelay_Decrement() the ticks in the period, so
+//delay_ms() only counts down when the period ends
+#define TASK_TICKLESS		0
+#define TASK_SCHED_MODE		TASK_SCHED_PRIORITY
+#define TASK_PROFILE		0
+
+
+//task ids, same as the priority passed to
+//Task_AddTask() and the index in the table
+typedef enum
+{
+	TASK_ID_RED,		//red led
+	TASK_ID_GREEN,		//green led
+	TASK_ID_LAST,
+
+}TaskID_t;
+
+
+#endif /* TASK_CONFIG_H_ */
@@ -21,7 +21,7 @@ static volatile int TimeDelay;
 
 //prototypes
 void delay_ms(volatile int ticks);
-void TimeDelay_Decrement(void);
+void TimeDelay_Decrement(uint16_t ticks);
 void GPIO_init(void);
 void TimerA_init(void);
 void Interrupt_init(void);
@@ -52,9 +52,10 @@ int main(void)
 	/////////////////////////////////////////
 	//configure the scheduler with some tasks
 	Task_Init();
-	Task_AddTask("taskTx", TaskFunction_TX, 500, 0);	//name, function, period, priority
-	Task_AddTask("taskRx", TaskFunction_RX, 100, 1);	//name, function, period, priority
-	Task_AddTask("green", TaskFunction_LedGreen, 100, 2);	//name, function, period, priority
+	Task_AddTask("taskTx", TaskFunction_TX, 500, TASK_ID_TX);		//name, function, period, priority
+	Task_AddTask("taskRx", TaskFunction_RX, 100, TASK_ID_RX);		//name, function, period, priority
+	Task_AddTask("green", TaskFunction_LedGreen, 100, TASK_ID_GREEN);	//name, function, period, priority
+	Task_AttachMessageQueue(TASK_ID_RX);								//rx takes messages
 
 	Task_StartScheduler();								//Timer takes over
 
@@ -77,11 +78,10 @@ void TaskFunction_TX(void)
 	//value = 0 is red led
 	uint8_t i = 0;
 	TaskMessage msg = {TASK_SIG_TOGGLE, 0x00};
-	uint8_t index = Task_GetIndexFromName("taskRx");
 
 	//odd number so the red led toggles
 	for (i = 0 ; i < 5 ; i++)
-		Task_SendMessage(index, msg);
+		Task_SendMessage(TASK_ID_RX, msg);
 
 }
 
@@ -92,9 +92,8 @@ void TaskFunction_TX(void)
 void TaskFunction_RX(void)
 {
 	TaskMessage msg = {TASK_SIG_NONE, 0x00};
-	uint8_t index = Task_GetIndexFromName("taskRx");
 
-	while (Task_GetNextMessage(index, &msg) > 0)
+	while (Task_GetNextMessage(TASK_ID_RX, &msg) > 0)
 	{
 		switch(msg.signal)
 		{
@@ -153,12 +152,18 @@ void delay_ms(volatile int ticks)
 
 
 /////////////////////////////////////////
-//Function called from the TimerA ISR
-void TimeDelay_Decrement(void)
+//Function called from the TimerA ISR with
+//the ticks since the last one, 1 unless
+//tickless
+void TimeDelay_Decrement(uint16_t ticks)
 {
-	if (TimeDelay != 0x00)
+	if (TimeDelay > (int)ticks)
 	{
-		TimeDelay--;
+		TimeDelay -= ticks;
+	}
+	else
+	{
+		TimeDelay = 0;
 	}
 }
 
@@ -274,12 +279,27 @@ void LedGreen_Clear(void)
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer_A(void)
 {
+#if TASK_TICKLESS
+	uint32_t start;
+#endif
+
 	//clear the timer interrupt
 	TACTL &=~ BIT0;
 
-	TimeDelay_Decrement();
+#if TASK_TICKLESS
+	start = Task_GetTickCount();
+
+	Task_TimerISRHandler();		//task table
+
+	//one interrupt is the whole period the
+	//tasker programmed, not one tick
+	TimeDelay_Decrement(Task_GetTickCount() - start);
+#else
+	TimeDelay_Decrement(1);
 
 	Task_TimerISRHandler();		//task table
+#endif
+	TASK_WAKE_ON_EXIT();		//run the scheduler if tickless
 }
 
 
@@ -0,0 +1,51 @@
+/*
+ * task_config.h
+ *
+ *  Tasker settings for msp430_tasksigs.  See
+ *  common/task/task.h for the options.
+ *
+ */
+
+#ifndef TASK_CONFIG_H_
+#define TASK_CONFIG_H_
+
+#define TASK_MAX_TASK		3			//tx, rx, green
+#define TASK_USE_NAMES		1
+#define TASK_USE_MESSAGES	1
+#define TASK_MESSAGE_SIZE	8			//ring buffer size, power of 2
+#define TASK_MESSAGE_QUEUES	1			//rx is the only task that takes messages
+#define TASK_MESSAGE_VALUE_TYPE	uint16_t	//value = 0 red led, 1 green led
+#define TASK_MESSAGE_WAKE	0			//rx polls at its period
+
+//with tickless the Timer_A isr in main.c passes
+//TimeDelay_Decrement() the ticks in the period, so
+//delay_ms() only counts down when the period ends
+#define TASK_TICKLESS		0
+#define TASK_SCHED_MODE		TASK_SCHED_PRIORITY
+#define TASK_PROFILE		0
+
+
+typedef enum
+{
+	TASK_SIG_NONE,		//do nothing
+	TASK_SIG_ON,		//led on
+	TASK_SIG_OFF,		//led off
+	TASK_SIG_TOGGLE,	//led toggle
+	TASK_SIG_LAST,
+
+}TaskSignal_t;
+
+
+//task ids, same as the priority passed to
+//Task_AddTask() and the index in the table
+typedef enum
+{
+	TASK_ID_TX,			//sends toggle messages
+	TASK_ID_RX,			//receives messages, red led
+	TASK_ID_GREEN,		//green led
+	TASK_ID_LAST,
+
+}TaskID_t;
+
+
+#endif /* TASK_CONFIG_H_ */
@@ -0,0 +1,1209 @@
+/*
+ * task.c
+ *
+ *  Created on: Nov 25, 2017
+ *      Author: danao
+ *
+ *  Shared by the msp430 projects, settings
+ *  are in each project's task_config.h
+ */
+///////////////////////////////////////////////////////
+/*
+Simple Tasker using a timer and a while loop.  One should
+be able to implement this on any processor that has a timer
+with ability to produce an interrupt at a known tick rate.
+
+How to use:
+
+On the main program, initialize timer and other hardware
+In the timer isr, call the following function: Task_TimerISRHandler()
+
+In the main program, start the Scheduler using the following: Task_StartScheduler()
+
+Initialize tasks using Task_AddTask() - requires name, function, period, priority
+If using signals, update the TaskSignal_t values in task_config.h.  it would be better to
+pass a pointer to a signal table to make it so tasks could have thier own signal list.
+
+Names (TASK_USE_NAMES) and messages (TASK_USE_MESSAGES) are
+only compiled in when task_config.h turns them on.
+
+See example in main for how to implement.
+
+Timer list:
+Enabled tasks are kept in a delta list sorted by time to
+run.  Each entry holds the number of ticks after the entry
+in front of it, so the timer isr only counts down the head
+of the list.  Ticks where no task times out cost the same
+regardless of the number of tasks.  Tasks that time out
+are moved back into the list at thier period.
+
+Ready set:
+The timer isr sets a bit per task that timed out.  The
+scheduler runs the lowest set bit (index 0 is the highest
+priority) found with a nibble lookup table, so picking the
+next task takes the same time no matter how many tasks
+there are.
+
+Tickless idle (TASK_TICKLESS):
+The timer period is set to the delta at the head of the
+list, so the timer isr only fires when a task times out
+(or every TASK_TICKLESS_MAX ticks).  When no task is ready,
+the scheduler sleeps in TASK_TICKLESS_LPM_BITS.  Port
+isrs that post messages wake it with TASK_WAKE_ON_EXIT().
+Task_GetSleepTicks() returns the total ticks spent asleep.
+
+Scheduling (TASK_SCHED_MODE):
+Each timeout sets a deadline at the next timeout.  The
+default runs ready tasks by index.  TASK_SCHED_EDF runs
+the ready task with the earliest deadline, so a low index
+task that runs long can't hold off the others forever.
+A run that ends after its deadline is a missed deadline,
+a timeout while the task is still waiting is a coalesced
+(lost) period.  Both are counted for each task.
+
+Profiling (TASK_PROFILE):
+Each run is timed with TimerA1.  The timer isr stamps
+the time a task times out, so the start jitter is the
+time from the timeout to the task starting.  Stats are
+passed to a print function with Task_ProfileDump().
+
+Task table:
+The task table is a set of arrays, one per field, so the
+byte fields don't get padded out to words.  The enable
+flags are a bit set like the ready set, and names are
+pointers to the strings in flash.
+
+Messages (TASK_USE_MESSAGES):
+Tasks that take messages get a queue from a pool of
+TASK_MESSAGE_QUEUES with Task_AttachMessageQueue().  Each
+queue is a ring buffer of TASK_MESSAGE_SIZE messages,
+read oldest first.  One side moves the head, the other the
+tail, so isrs can post without disabling interrupts.  Post
+to a given task from isrs only or from tasks only.  Messages
+posted to a full queue are dropped and counted, see
+Task_GetMessageOverflow().
+
+Wake on message (TASK_MESSAGE_WAKE):
+A post to a task in the wake set also sets its ready bit,
+same as a timeout, so the task runs on the next pass of the
+scheduler.  The ready bit is shared with the timer isr, so
+setting it takes a short critical section.  A post to a
+task that is already ready just leaves the message for it.
+
+ */
+//////////////////////////////////////////////////////
+#include <msp430.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "task.h"
+
+////////////////////////////////////////////
+//Critical section around the timer list.
+//Saves the GIE state so it can be used before
+//interrupts are enabled and from an isr.
+#ifndef TASK_ENTER_CRITICAL
+#define TASK_ENTER_CRITICAL(state)	do { (state) = __get_SR_register() & GIE; __disable_interrupt(); } while (0)
+#define TASK_EXIT_CRITICAL(state)	do { if (state) __enable_interrupt(); } while (0)
+#endif
+
+//////////////////////////////////////////
+//Task table, one array per field so there's
+//no padding between the byte fields.  The
+//index in each array is the task index.
+static void (*TaskFunction[TASK_MAX_TASK]) (void);	//function to run, NULL_PTR if slot is free
+static uint16_t TaskTimer[TASK_MAX_TASK];			//frequency to run task
+static uint16_t TaskTimeTick[TASK_MAX_TASK];		//countdown value, relative to previous task in the timer list
+static uint8_t TaskNextTimer[TASK_MAX_TASK];		//next task in the timer list, TASK_INDEX_NONE at the end
+static uint32_t TaskDeadline[TASK_MAX_TASK];		//tick count the current run has to finish by
+static uint16_t TaskMissedDeadline[TASK_MAX_TASK];	//runs that finished after the deadline
+static uint16_t TaskCoalesced[TASK_MAX_TASK];		//timeouts while still waiting to run (lost periods)
+static TaskReady_t TaskEnableSet = 0;				//bit per task, set if enabled
+
+#if TASK_USE_NAMES
+static const char* TaskName[TASK_MAX_TASK];			//task name, points to a string in flash
+#endif
+
+#if TASK_USE_MESSAGES
+//////////////////////////////////////////
+//Message queue pool.  Tasks that take messages
+//get a queue with Task_AttachMessageQueue(),
+//the rest don't use any queue ram.
+typedef struct
+{
+	volatile uint8_t head;						//next slot to post to, moved by the sender
+	volatile uint8_t tail;						//next slot to read, moved by the receiver
+	uint8_t overflow;							//messages dropped on a full queue
+	volatile TaskMessage message[TASK_MESSAGE_SIZE];	//ring buffer, oldest first
+}TaskQueue;
+
+static TaskQueue TaskQueuePool[TASK_MESSAGE_QUEUES];
+static uint8_t TaskQueueIndex[TASK_MAX_TASK];		//queue for each task, TASK_INDEX_NONE if none
+static uint8_t TaskQueueCount = 0;					//queues handed out
+
+#if TASK_MESSAGE_WAKE
+static TaskReady_t TaskWakeSet = 0;					//bit per task, set if a post makes it ready
+#endif
+#endif
+
+static uint8_t TaskTimerHead = TASK_INDEX_NONE;		//first task in the timer list
+static volatile uint16_t TaskTickPeriod = 1;			//ticks in the current timer period
+static volatile uint32_t TaskTickCount = 0;				//ticks since start
+static uint32_t TaskSleepTicks = 0;						//ticks spent in low power
+static volatile TaskReady_t TaskReadySet = 0;			//bit per task, set on timeout
+
+#define TASK_READY_BIT(i)	((TaskReady_t)1 << (i))
+
+//////////////////////////////////////////
+//lowest set bit in a nibble, 1 based so
+//0 means no bit set (like QF_log2Lkup, but
+//from the low end since index 0 is the
+//highest priority)
+static const uint8_t TaskLowBitLkup[16] =
+{
+	0, 1, 2, 1, 3, 1, 2, 1, 4, 1, 2, 1, 3, 1, 2, 1
+};
+
+static void Task_TimerStart(uint8_t index, uint16_t ticks);
+static void Task_TimerInsert(uint8_t index, uint16_t ticks);
+static void Task_TimerRemove(uint8_t index);
+static void Task_TimerAdvance(uint16_t ticks);
+static uint16_t Task_TimerElapsed(void);
+static uint16_t Task_Period(uint8_t index);
+static uint8_t Task_ReadyFirst(TaskReady_t ready);
+static void Task_CountUp(uint16_t *count);
+
+#if TASK_SCHED_MODE == TASK_SCHED_EDF
+static uint8_t Task_ReadyEarliest(TaskReady_t ready);
+#endif
+
+#if TASK_PROFILE
+static TaskProfile TaskProfileTable[TASK_MAX_TASK];
+static void Task_ProfileRun(uint8_t index);
+#endif
+
+#if TASK_USE_MESSAGES
+static TaskQueue* Task_GetQueue(uint8_t index);
+#if TASK_MESSAGE_WAKE
+static void Task_MessageReady(uint8_t index);
+#endif
+#endif
+
+#if TASK_TICKLESS
+static void Task_TicklessProgram(uint16_t minTicks);
+static void Task_TicklessIdle(void);
+#endif
+
+///////////////////////////////////////
+//Init task table with default values
+void Task_Init(void)
+{
+	uint8_t i;
+	for (i = 0 ; i < TASK_MAX_TASK ; i++)
+	{
+#if TASK_USE_NAMES
+		TaskName[i] = NULL_PTR;
+#endif
+		TaskFunction[i] = NULL_PTR;
+		TaskTimer[i] = 0;
+		TaskTimeTick[i] = 0;
+		TaskNextTimer[i] = TASK_INDEX_NONE;
+		TaskDeadline[i] = 0;
+		TaskMissedDeadline[i] = 0;
+		TaskCoalesced[i] = 0;
+#if TASK_USE_MESSAGES
+		TaskQueueIndex[i] = TASK_INDEX_NONE;
+#endif
+	}
+
+	TaskTimerHead = TASK_INDEX_NONE;
+	TaskReadySet = 0;
+	TaskEnableSet = 0;
+
+#if TASK_USE_MESSAGES
+	TaskQueueCount = 0;
+#if TASK_MESSAGE_WAKE
+	TaskWakeSet = 0;
+#endif
+#endif
+
+#if TASK_PROFILE
+	TASK_PROFILE_TIMER_START();
+	Task_ProfileReset();
+#endif
+}
+
+/////////////////////////////////////////////
+//Task_AddTask
+//Add a task to the task table.  needs to fit
+//within the size, priority = index in the table
+//*task is the task to run
+//returns the index, which is the handle used
+//for the other calls (messages, enable..), or
+//-1 if the slot is taken or out of range
+//The name is not copied, pass a string constant.
+int Task_AddTask(const char* name, void (*taskFunction) (void), uint16_t time, uint8_t priority)
+{
+	uint16_t state;
+
+	//check priority and if the task function is set up
+	if (priority < TASK_MAX_TASK)
+	{
+		if (TaskFunction[priority] == NULL_PTR)
+		{
+			TASK_ENTER_CRITICAL(state);
+
+#if TASK_USE_NAMES
+			TaskName[priority] = name;							//string stays in flash
+#else
+			(void)name;
+#endif
+
+			TaskEnableSet |= TASK_READY_BIT(priority);			//task enable
+			TaskFunction[priority] = taskFunction;				//function pointer
+			TaskTimer[priority] = time;							//timeout
+			TaskReadySet &= ~TASK_READY_BIT(priority);			//set on timeout, polled in main
+			TaskMissedDeadline[priority] = 0;
+			TaskCoalesced[priority] = 0;
+			Task_TimerStart(priority, time);					//set the timeout
+
+#if TASK_USE_MESSAGES
+			Task_ClearAllMessages(priority);
+#endif
+
+			TASK_EXIT_CRITICAL(state);
+
+			return priority;
+		}
+
+		//function pointer already assigned
+		else
+			return -1;
+	}
+
+	return -1;
+}
+
+///////////////////////////////////////
+//loop through the task table until
+//we hit taskFunction and reset all the
+//values for that entry
+//pass the task function as arg
+int Task_RemoveTask(void (*taskFunction) (void))
+{
+	uint8_t i;
+	uint16_t state;
+
+	for (i = 0 ; i < TASK_MAX_TASK ; i++)
+	{
+		if (taskFunction == TaskFunction[i])
+		{
+			TASK_ENTER_CRITICAL(state);
+
+			Task_TimerRemove(i);
+#if TASK_USE_NAMES
+			TaskName[i] = NULL_PTR;
+#endif
+			TaskFunction[i] = NULL_PTR;
+			TaskTimer[i] = 0;
+			TaskEnableSet &= ~TASK_READY_BIT(i);
+			TaskReadySet &= ~TASK_READY_BIT(i);
+
+			//the queue stays with the slot
+#if TASK_USE_MESSAGES
+			Task_ClearAllMessages(i);
+#if TASK_MESSAGE_WAKE
+			TaskWakeSet &= ~TASK_READY_BIT(i);
+#endif
+#endif
+
+			TASK_EXIT_CRITICAL(state);
+
+			return i;
+		}
+	}
+
+	return -1;		//invalid function
+}
+
+void Task_EnableTask(uint8_t taskIndex)
+{
+	uint16_t state;
+
+	if (taskIndex < TASK_MAX_TASK)
+	{
+		//check null function
+		if (TaskFunction[taskIndex] != NULL_PTR)
+		{
+			TASK_ENTER_CRITICAL(state);
+
+			Task_TimerRemove(taskIndex);
+			TaskEnableSet |= TASK_READY_BIT(taskIndex);
+			TaskReadySet &= ~TASK_READY_BIT(taskIndex);
+			Task_TimerStart(taskIndex, TaskTimer[taskIndex]);
+
+			TASK_EXIT_CRITICAL(state);
+		}
+	}
+}
+
+void Task_DisableTask(uint8_t taskIndex)
+{
+	uint16_t state;
+
+	if (taskIndex < TASK_MAX_TASK)
+	{
+		//check null function
+		if (TaskFunction[taskIndex] != NULL_PTR)
+		{
+			TASK_ENTER_CRITICAL(state);
+
+			Task_TimerRemove(taskIndex);
+			TaskEnableSet &= ~TASK_READY_BIT(taskIndex);
+			TaskReadySet &= ~TASK_READY_BIT(taskIndex);
+
+			TASK_EXIT_CRITICAL(state);
+		}
+	}
+}
+
+////////////////////////////////////////////////
+//update the timeout value and the initial tick
+void Task_RescheduleTask(uint8_t taskIndex, uint16_t updatedTime)
+{
+	uint16_t state;
+
+	if (taskIndex < TASK_MAX_TASK)
+	{
+		//check null function
+		if (TaskFunction[taskIndex] != NULL_PTR)
+		{
+			TASK_ENTER_CRITICAL(state);
+
+			TaskTimer[taskIndex] = updatedTime;
+
+			//move it in the timer list if it's running
+			if (TaskEnableSet & TASK_READY_BIT(taskIndex))
+			{
+				Task_TimerRemove(taskIndex);
+				Task_TimerStart(taskIndex, updatedTime);
+			}
+
+			TASK_EXIT_CRITICAL(state);
+		}
+	}
+}
+
+
+
+#if TASK_USE_NAMES
+////////////////////////////////////////////
+int Task_GetIndexFromName(const char* name)
+{
+	uint8_t i;
+	for (i = 0 ; i < TASK_MAX_TASK ; i++)
+	{
+		//get the index from name, set the signal and value
+		if ((TaskName[i] != NULL_PTR) && !strcmp(name, TaskName[i]))
+		{
+			return i;
+		}
+	}
+
+	return -1;		//invalid name
+}
+#endif
+
+
+
+
+/////////////////////////////////////////
+//Main loop routine.  should never
+//stop.  called in main.
+void Task_StartScheduler(void)
+{
+	uint8_t i = 0;
+	TaskReady_t ready;
+	uint16_t state;
+	uint32_t deadline;
+
+#if TASK_TICKLESS
+	//take over TACCR0 from the fixed tick
+	TASK_ENTER_CRITICAL(state);
+	Task_TicklessProgram(Task_TimerElapsed() + 1);
+	TASK_EXIT_CRITICAL(state);
+#endif
+
+	while (1)
+	{
+		//run the highest priority ready task
+		ready = TaskReadySet;
+
+		if (ready != 0)
+		{
+#if TASK_SCHED_MODE == TASK_SCHED_EDF
+			i = Task_ReadyEarliest(ready);
+#else
+			i = Task_ReadyFirst(ready);
+#endif
+
+			//the isr only sets the deadline when the
+			//ready bit is clear, so grab it here
+			TASK_ENTER_CRITICAL(state);
+			TaskReadySet &= ~TASK_READY_BIT(i);
+			deadline = TaskDeadline[i];
+			TASK_EXIT_CRITICAL(state);
+
+#if TASK_PROFILE
+			Task_ProfileRun(i);
+#else
+			TaskFunction[i]();
+#endif
+
+			//finished at or after the next timeout
+			if ((int32_t)(Task_GetTickCount() - deadline) >= 0)
+				Task_CountUp(&TaskMissedDeadline[i]);
+		}
+
+		//nothing ready to run
+#if TASK_TICKLESS
+		else
+			Task_TicklessIdle();
+#else
+		else
+			TASK_IDLE_HOOK();
+#endif
+	}
+}
+
+
+//////////////////////////////////////
+//Call this function in the timer isr
+//Configure the timer to rollover
+//at same speed, 2x, 3x... as the rate
+//we want to run the tasker.
+
+//Count down the head of the timer list by
+//the ticks in the timer period (1 unless
+//tickless).  With tickless idle, program
+//the period up to the next timeout.
+
+void Task_TimerISRHandler(void)
+{
+	uint16_t ticks = TaskTickPeriod;
+
+	TaskTickCount += ticks;
+	Task_TimerAdvance(ticks);
+
+#if TASK_TICKLESS
+	Task_TicklessProgram(1);
+#endif
+}
+
+
+///////////////////////////////////////////
+//Ticks since the timer started, including
+//the part of a tickless period already gone.
+uint32_t Task_GetTickCount(void)
+{
+	uint32_t count;
+	uint16_t state;
+
+	TASK_ENTER_CRITICAL(state);
+	count = TaskTickCount + Task_TimerElapsed();
+	TASK_EXIT_CRITICAL(state);
+
+	return count;
+}
+
+///////////////////////////////////////////
+//Total ticks the scheduler spent in low
+//power mode.  Always 0 unless tickless.
+uint32_t Task_GetSleepTicks(void)
+{
+	uint32_t ticks;
+	uint16_t state;
+
+	TASK_ENTER_CRITICAL(state);
+	ticks = TaskSleepTicks;
+	TASK_EXIT_CRITICAL(state);
+
+	return ticks;
+}
+
+///////////////////////////////////////////
+//Number of runs that finished after the
+//task timed out again.  Stops at 0x7FFF.
+int Task_GetMissedDeadlines(uint8_t index)
+{
+	if (index < TASK_MAX_TASK)
+	{
+		return TaskMissedDeadline[index];
+	}
+
+	return -1;		//invalid index
+}
+
+///////////////////////////////////////////
+//Number of timeouts that were dropped because
+//the task hadn't run since the last one, so
+//the task ran once for two or more periods.
+//Stops at 0x7FFF.
+int Task_GetCoalescedPeriods(uint8_t index)
+{
+	uint16_t state;
+	int count;
+
+	if (index < TASK_MAX_TASK)
+	{
+		TASK_ENTER_CRITICAL(state);
+		count = TaskCoalesced[index];
+		TASK_EXIT_CRITICAL(state);
+
+		return count;
+	}
+
+	return -1;		//invalid index
+}
+
+
+#if TASK_PROFILE
+///////////////////////////////////////////
+//Clear the run stats for all tasks.  The
+//ready stamps are left alone so a task that
+//is waiting to run still gets its jitter.
+void Task_ProfileReset(void)
+{
+	uint8_t i;
+
+	for (i = 0 ; i < TASK_MAX_TASK ; i++)
+	{
+		TaskProfileTable[i].runMin = 0xFFFF;
+		TaskProfileTable[i].runMax = 0;
+		TaskProfileTable[i].runTotal = 0;
+		TaskProfileTable[i].runCount = 0;
+		TaskProfileTable[i].jitterMax = 0;
+		TaskProfileTable[i].jitterTotal = 0;
+		TaskProfileTable[i].overrun = 0;
+	}
+}
+
+///////////////////////////////////////////
+//Pass the stats for each task in the table
+//to print().  There's no uart in the tasker,
+//so print() formats and sends them out
+//wherever (uart, lcd, debugger..).  Call it
+//from a task, not an isr.
+void Task_ProfileDump(void (*print) (uint8_t index, const TaskProfile *profile))
+{
+	uint8_t i;
+
+	for (i = 0 ; i < TASK_MAX_TASK ; i++)
+	{
+		if (TaskFunction[i] != NULL_PTR)
+			print(i, &TaskProfileTable[i]);
+	}
+}
+
+///////////////////////////////////////////
+//Task_ProfileRun
+//Run a task and update its stats.  Run time
+//and jitter are timer counts, so anything
+//over 32ms wraps.  Overruns are checked with
+//the tick count so long tasks still count, a
+//period 0 task overruns when it takes a tick.
+//
+static void Task_ProfileRun(uint8_t index)
+{
+	TaskProfile *profile = &TaskProfileTable[index];
+	uint16_t start;
+	uint16_t run;
+	uint16_t jitter;
+	uint32_t startTick;
+
+	start = TASK_PROFILE_TIMER;
+	startTick = Task_GetTickCount();
+	jitter = start - profile->readyStamp;
+
+	TaskFunction[index]();
+
+	run = TASK_PROFILE_TIMER - start;
+
+	if (run < profile->runMin)
+		profile->runMin = run;
+	if (run > profile->runMax)
+		profile->runMax = run;
+	profile->runTotal += run;
+	profile->runCount++;
+
+	if (jitter > profile->jitterMax)
+		profile->jitterMax = jitter;
+	profile->jitterTotal += jitter;
+
+	if ((Task_GetTickCount() - startTick) >= Task_Period(index))
+		profile->overrun++;
+}
+#endif
+
+
+////////////////////////////////////////////
+//Task_TimerAdvance
+//Take ticks off the head of the timer list.
+//Every task whose delta runs out gets the
+//run flag and goes back in the list at it's
+//period.  Tasks behind the head with a zero
+//delta time out on the same tick.
+//Call with interrupts disabled.
+//
+static void Task_TimerAdvance(uint16_t ticks)
+{
+	uint8_t i;
+
+	while (TaskTimerHead != TASK_INDEX_NONE)
+	{
+		if (TaskTimeTick[TaskTimerHead] > ticks)
+		{
+			TaskTimeTick[TaskTimerHead] -= ticks;
+			break;
+		}
+
+		//pop the head, set the ready bit polled
+		//in main, reload at the task period
+		i = TaskTimerHead;
+		ticks -= TaskTimeTick[i];
+		TaskTimerHead = TaskNextTimer[i];
+
+		//still waiting from the last timeout, this
+		//period is lost.  keep the old deadline.
+		if (TaskReadySet & TASK_READY_BIT(i))
+		{
+			Task_CountUp(&TaskCoalesced[i]);
+		}
+
+		else
+		{
+			//timed out ticks ago, due by the next timeout
+			TaskDeadline[i] = TaskTickCount - ticks + Task_Period(i);
+			TaskReadySet |= TASK_READY_BIT(i);
+
+#if TASK_PROFILE
+			TaskProfileTable[i].readyStamp = TASK_PROFILE_TIMER;
+#endif
+		}
+
+		Task_TimerInsert(i, TaskTimer[i]);
+	}
+}
+
+
+////////////////////////////////////////////
+//Task_TimerElapsed
+//Whole ticks gone in the current timer
+//period.  The list is only advanced in the
+//isr, so this is how far the list is behind.
+//Always 0 unless tickless.
+//Call with interrupts disabled.
+//
+static uint16_t Task_TimerElapsed(void)
+{
+#if TASK_TICKLESS
+	//period is over, isr is waiting to run
+	if (TACCTL0 & CCIFG)
+		return TaskTickPeriod;
+
+	return TAR / TASK_TICK_COUNTS;
+#else
+	return 0;
+#endif
+}
+
+
+////////////////////////////////////////////
+//Task_ReadyFirst
+//Index of the lowest set bit, which is the
+//highest priority ready task.  Two or three
+//steps no matter how many tasks are ready.
+//ready can't be 0.
+//
+static uint8_t Task_ReadyFirst(TaskReady_t ready)
+{
+	uint8_t n = 0;
+
+#if TASK_MAX_TASK > 8
+	if ((ready & 0x00FF) == 0)
+	{
+		ready >>= 8;
+		n = 8;
+	}
+#endif
+
+	if ((ready & 0x0F) == 0)
+	{
+		ready >>= 4;
+		n += 4;
+	}
+
+	return n + TaskLowBitLkup[ready & 0x0F] - 1;
+}
+
+
+#if TASK_SCHED_MODE == TASK_SCHED_EDF
+////////////////////////////////////////////
+//Task_ReadyEarliest
+//Ready task with the earliest deadline.  Only
+//looks at the ready tasks, lowest index wins a
+//tie.  ready can't be 0.
+//
+static uint8_t Task_ReadyEarliest(TaskReady_t ready)
+{
+	uint8_t i;
+	uint8_t best;
+
+	best = Task_ReadyFirst(ready);
+	ready &= ~TASK_READY_BIT(best);
+
+	while (ready != 0)
+	{
+		i = Task_ReadyFirst(ready);
+		ready &= ~TASK_READY_BIT(i);
+
+		if ((int32_t)(TaskDeadline[i] - TaskDeadline[best]) < 0)
+			best = i;
+	}
+
+	return best;
+}
+#endif
+
+
+////////////////////////////////////////////
+//Task_Period
+//Ticks between timeouts.  A period of 0 runs
+//every tick, the same as Task_TimerInsert().
+//
+static uint16_t Task_Period(uint8_t index)
+{
+	return TaskTimer[index] ? TaskTimer[index] : 1;
+}
+
+
+////////////////////////////////////////////
+//Task_CountUp
+//Add one to a stats counter, stop at the
+//largest value an int can return.
+//
+static void Task_CountUp(uint16_t *count)
+{
+	if (*count < 0x7FFF)
+		(*count)++;
+}
+
+
+////////////////////////////////////////////
+//Task_TimerStart
+//Put a task in the timer list from outside
+//the timer isr.  Add the ticks the list is
+//behind, and shorten the tickless period if
+//the task is now first to time out.
+//Call with interrupts disabled.
+//
+static void Task_TimerStart(uint8_t index, uint16_t ticks)
+{
+	uint16_t elapsed = Task_TimerElapsed();
+
+	if (!ticks)
+		ticks = 1;
+
+	Task_TimerInsert(index, ticks + elapsed);
+
+#if TASK_TICKLESS
+	if (!(TACCTL0 & CCIFG))
+		Task_TicklessProgram(elapsed + 1);
+#endif
+}
+
+
+////////////////////////////////////////////
+//Task_TimerInsert
+//Put a task into the timer list so it times
+//out after ticks.  Walk the list subtracting
+//each delta until we find where it goes, then
+//take it's delta off the entry behind it.
+//Call with interrupts disabled.
+//
+static void Task_TimerInsert(uint8_t index, uint16_t ticks)
+{
+	uint8_t prev = TASK_INDEX_NONE;
+	uint8_t curr = TaskTimerHead;
+
+	//a period of 0 would never leave the list
+	if (!ticks)
+		ticks = 1;
+
+	//tasks with the same timeout run in the
+	//order they went into the list
+	while ((curr != TASK_INDEX_NONE) && (TaskTimeTick[curr] <= ticks))
+	{
+		ticks -= TaskTimeTick[curr];
+		prev = curr;
+		curr = TaskNextTimer[curr];
+	}
+
+	TaskTimeTick[index] = ticks;
+	TaskNextTimer[index] = curr;
+
+	if (curr != TASK_INDEX_NONE)
+		TaskTimeTick[curr] -= ticks;
+
+	if (prev == TASK_INDEX_NONE)
+		TaskTimerHead = index;
+	else
+		TaskNextTimer[prev] = index;
+}
+
+
+////////////////////////////////////////////
+//Task_TimerRemove
+//Take a task out of the timer list and give
+//it's remaining delta to the entry behind it.
+//Does nothing if the task is not in the list.
+//Call with interrupts disabled.
+//
+static void Task_TimerRemove(uint8_t index)
+{
+	uint8_t prev = TASK_INDEX_NONE;
+	uint8_t curr = TaskTimerHead;
+
+	while ((curr != TASK_INDEX_NONE) && (curr != index))
+	{
+		prev = curr;
+		curr = TaskNextTimer[curr];
+	}
+
+	if (curr == TASK_INDEX_NONE)
+		return;
+
+	if (TaskNextTimer[index] != TASK_INDEX_NONE)
+		TaskTimeTick[TaskNextTimer[index]] += TaskTimeTick[index];
+
+	if (prev == TASK_INDEX_NONE)
+		TaskTimerHead = TaskNextTimer[index];
+	else
+		TaskNextTimer[prev] = TaskNextTimer[index];
+
+	TaskNextTimer[index] = TASK_INDEX_NONE;
+	TaskTimeTick[index] = 0;
+}
+
+
+#if TASK_TICKLESS
+////////////////////////////////////////////
+//Task_TicklessProgram
+//Set the timer period to the delta at the
+//head of the list, no shorter than minTicks
+//(the part of the period already gone) and
+//no longer than what fits in TACCR0.
+//Call with interrupts disabled.
+//
+static void Task_TicklessProgram(uint16_t minTicks)
+{
+	uint16_t ticks = TASK_TICKLESS_MAX;
+
+	if ((TaskTimerHead != TASK_INDEX_NONE) && (TaskTimeTick[TaskTimerHead] < ticks))
+		ticks = TaskTimeTick[TaskTimerHead];
+
+	if (ticks < minTicks)
+		ticks = minTicks;
+
+	TaskTickPeriod = ticks;
+	TACCR0 = (ticks * TASK_TICK_COUNTS) - 1;
+}
+
+
+////////////////////////////////////////////
+//Task_TicklessIdle
+//Sleep until the timer or a port isr wakes
+//us up.  Check the ready bits with interrupts
+//off so a task made ready by an isr is not
+//missed.  GIE and the low power bits are set
+//in one instruction.
+//
+static void Task_TicklessIdle(void)
+{
+	uint32_t start;
+
+	__disable_interrupt();
+
+	if (TaskReadySet != 0)
+	{
+		__enable_interrupt();
+		return;
+	}
+
+	start = TaskTickCount + Task_TimerElapsed();
+
+	__bis_SR_register(TASK_TICKLESS_LPM_BITS | GIE);
+	__no_operation();
+
+	__disable_interrupt();
+	TaskSleepTicks += (TaskTickCount + Task_TimerElapsed()) - start;
+	__enable_interrupt();
+}
+#endif
+
+
+#if TASK_USE_MESSAGES
+////////////////////////////////////////////
+//Give a task a queue from the pool so it can
+//take messages.  Call after Task_AddTask(),
+//before anything posts to the task.  Queues
+//are not given back, the queue stays with the
+//task index if the task is removed.
+//returns the queue number, -1 if error or
+//the pool is used up
+int Task_AttachMessageQueue(uint8_t index)
+{
+	uint16_t state;
+	int queue = -1;
+
+	if (index < TASK_MAX_TASK)
+	{
+		TASK_ENTER_CRITICAL(state);
+
+		if (TaskQueueIndex[index] != TASK_INDEX_NONE)
+		{
+			queue = TaskQueueIndex[index];			//already has one
+		}
+
+		else if (TaskQueueCount < TASK_MESSAGE_QUEUES)
+		{
+			queue = TaskQueueCount++;
+			TaskQueuePool[queue].head = 0;
+			TaskQueuePool[queue].tail = 0;
+			TaskQueuePool[queue].overflow = 0;
+			TaskQueueIndex[index] = queue;
+		}
+
+		TASK_EXIT_CRITICAL(state);
+	}
+
+	return queue;
+}
+
+
+////////////////////////////////////////////
+//Task_GetQueue
+//Queue for a task, NULL_PTR if the index is
+//bad or the task doesn't have a queue.
+//
+static TaskQueue* Task_GetQueue(uint8_t index)
+{
+	if ((index < TASK_MAX_TASK) && (TaskQueueIndex[index] != TASK_INDEX_NONE))
+		return &TaskQueuePool[TaskQueueIndex[index]];
+
+	return NULL_PTR;
+}
+
+
+////////////////////////////////////////////
+//Clear all messages in the task's queue.
+//Drops everything waiting by moving the tail
+//up to the head, so only call it from the
+//receiving task or when no one is posting to
+//the task.  Also clears the overflow count.
+int Task_ClearAllMessages(uint8_t element)
+{
+	TaskQueue *queue = Task_GetQueue(element);
+
+	if (queue != NULL_PTR)
+	{
+		queue->tail = queue->head;
+		queue->overflow = 0;
+
+		return 1;
+	}
+
+	return -1;		//invalid index or no queue
+}
+
+
+/////////////////////////////////////////
+//Send message to a task.
+//Each queue is a single producer, single
+//consumer ring buffer.  The sender writes the
+//message and then moves the head, the receiver
+//only moves the tail, so posting from an isr
+//does not need interrupts disabled.  The slots
+//are volatile like head and tail, so the compiler
+//can't move the message store after the head.  All the
+//senders to a task need to be in isrs (which
+//don't nest) or all in tasks, not both.
+//If the task wakes on messages, the ready bit
+//is set under a critical section after the
+//message is in the queue.
+//
+//Head and tail are free running 8 bit counters,
+//head - tail is the number waiting.
+//
+//returns the number of messages in the queue
+//after posting the message.  returns -1 if error
+//(no queue, task disabled) or the queue is full
+//(counted as an overflow).
+//
+int Task_SendMessage(uint8_t index, TaskMessage message)
+{
+	TaskQueue *queue = Task_GetQueue(index);
+	uint8_t head;
+
+	if ((queue != NULL_PTR) && (TaskEnableSet & TASK_READY_BIT(index)))
+	{
+		head = queue->head;
+
+		if ((uint8_t)(head - queue->tail) >= TASK_MESSAGE_SIZE)
+		{
+			if (queue->overflow < 0xFF)
+				queue->overflow++;
+
+			return -1;		//queue full
+		}
+
+		queue->message[head & TASK_MESSAGE_MASK] = message;
+		queue->head = head + 1;
+
+#if TASK_MESSAGE_WAKE
+		if (TaskWakeSet & TASK_READY_BIT(index))
+			Task_MessageReady(index);
+#endif
+
+		return (uint8_t)(head + 1 - queue->tail);
+	}
+
+	return -1;		//invalid index
+}
+
+
+
+/////////////////////////////////////////////
+
+int Task_GetNumMessageWaiting(uint8_t index)
+{
+	TaskQueue *queue = Task_GetQueue(index);
+
+	if (queue != NULL_PTR)
+	{
+		return (uint8_t)(queue->head - queue->tail);
+	}
+
+	return -1;		//invalid index
+}
+
+
+////////////////////////////////////////////////////
+//Dequeue the oldest message if any are waiting.
+//Load the msg ptr, then move the tail.  Returns
+//the num messages waiting before the dequeue, so
+//while (Task_GetNextMessage() > 0) reads them all,
+//-1 if error (invalid index or no queue)
+//
+int Task_GetNextMessage(uint8_t index, TaskMessage *msg)
+{
+	TaskQueue *queue = Task_GetQueue(index);
+	uint8_t tail;
+	uint8_t waiting;
+
+	if (queue != NULL_PTR)
+	{
+		tail = queue->tail;
+		waiting = queue->head - tail;
+
+		if (waiting > 0)
+		{
+			*msg = queue->message[tail & TASK_MESSAGE_MASK];
+			queue->tail = tail + 1;
+
+			return waiting;
+		}
+
+		else
+		{
+			return 0;
+		}
+	}
+
+	return -1;		//invalid index
+}
+
+
+////////////////////////////////////////////////////
+//Number of messages dropped because the queue
+//was full.  Stops counting at 255.
+//
+int Task_GetMessageOverflow(uint8_t index)
+{
+	TaskQueue *queue = Task_GetQueue(index);
+
+	if (queue != NULL_PTR)
+	{
+		return queue->overflow;
+	}
+
+	return -1;		//invalid index
+}
+
+
+#if TASK_MESSAGE_WAKE
+////////////////////////////////////////////////////
+//Turn wake on message on (wake = 1) or off for a
+//task.  The task needs a queue first, see
+//Task_AttachMessageQueue().
+//returns 1, -1 if error (invalid index or no queue)
+//
+int Task_SetMessageWake(uint8_t index, uint8_t wake)
+{
+	uint16_t state;
+
+	if (Task_GetQueue(index) != NULL_PTR)
+	{
+		TASK_ENTER_CRITICAL(state);
+
+		if (wake)
+			TaskWakeSet |= TASK_READY_BIT(index);
+		else
+			TaskWakeSet &= ~TASK_READY_BIT(index);
+
+		TASK_EXIT_CRITICAL(state);
+
+		return 1;
+	}
+
+	return -1;		//invalid index or no queue
+}
+
+
+////////////////////////////////////////////
+//Task_MessageReady
+//Set the ready bit for a task that was just
+//posted to, like a timeout does.  The deadline
+//is one period from now.  If the task is already
+//ready it picks up the message on that run.
+//
+static void Task_MessageReady(uint8_t index)
+{
+	uint16_t state;
+
+	TASK_ENTER_CRITICAL(state);
+
+	if (!(TaskReadySet & TASK_READY_BIT(index)))
+	{
+		TaskDeadline[index] = TaskTickCount + Task_TimerElapsed() + Task_Period(index);
+		TaskReadySet |= TASK_READY_BIT(index);
+
+#if TASK_PROFILE
+		TaskProfileTable[index].readyStamp = TASK_PROFILE_TIMER;
+#endif
+	}
+
+	TASK_EXIT_CRITICAL(state);
+}
+#endif
+#endif
@@ -0,0 +1,291 @@
+/*
+ * task.h
+ *
+ *  Created on: Nov 25, 2017
+ *      Author: danao
+ *
+ *  Simple tasker shared by the msp430 projects,
+ *  with optional task names and message handling
+ *  from one task to another.
+ *
+ */
+///////////////////////////////////////////////////////
+/*
+Simple Tasker using a timer and a while loop.  One should
+be able to implement this on any processor that has a timer
+with ability to produce an interrupt at a known tick rate.
+
+How to use:
+
+Each project has a task_config.h on the include path that
+sets the number of tasks, turns names and messages on or
+off, sets the queue size, number of queues and message value
+type, and lists the TaskSignal_t and TaskID_t values for the
+project.  Only the parts that are turned on take up ram.
+
+On the main program, initialize timer and other hardware
+In the timer isr, call the following function: Task_TimerISRHandler()
+
+In the main program, start the Scheduler using the following: Task_StartScheduler()
+
+Initialize tasks using Task_AddTask() - requires name, function, period, priority.
+A task runs every period ticks (the tasker before the delta
+list ran it every period + 1, see README.md).
+The name is ignored if TASK_USE_NAMES is 0, otherwise only the pointer
+is kept so pass a string constant.  Task_AddTask() returns the
+task index, use it (or the TaskID_t value) as the handle for messages.
+Task_GetIndexFromName() is a strcmp over the table, so keep it out of isrs.
+
+Tasks can signal one another using Task_SendMessage() if
+TASK_USE_MESSAGES is 1.  A task needs a queue to take messages,
+call Task_AttachMessageQueue() after adding it.  Queues come
+from a pool of TASK_MESSAGE_QUEUES.  Update TaskSignal_t in
+task_config.h with the appropriate messages.  Define TASK_MESSAGE_VALUE_TYPE
+to add a value of that type to each message, leave it out if
+the signal is all you need.  With TASK_MESSAGE_WAKE, a task
+set up with Task_SetMessageWake() runs right after a post
+instead of at its next timeout.
+
+For sending messages, you need a sender and reciever.
+
+//////////////////////////////////////////////////
+Ex: Send TASK_SIG_TOGGLE to TASK_ID_RX
+
+Sender Task Code:
+
+TaskMessage msg = {TASK_SIG_TOGGLE, 0x00};			//make a message
+Task_SendMessage(TASK_ID_RX, msg);					//send the message
+
+
+
+Receiver Task Code:
+
+TaskMessage msg = {TASK_SIG_NONE, 0x00};			//make a msg struct
+while (Task_GetNextMessage(TASK_ID_RX, &msg) > 0)	//get all messages
+{
+	//do something depending on the signal,
+	//value, etc
+	switch(msg.signal)
+	{
+		//blah, blah....
+	}
+
+}
+
+
+Note: Receive messages all get processed the next
+time the task runs, which is the next timeout unless
+the task wakes on messages.
+
+See README.md for the ram used by each option.
+
+ */
+//////////////////////////////////////////////////////
+
+
+#ifndef TASK_TASK_H_
+#define TASK_TASK_H_
+
+#include <stdint.h>			//uint32_t..etc
+
+#define TASK_SCHED_PRIORITY		0
+#define TASK_SCHED_EDF			1
+
+#include "task_config.h"	//per project settings, signals and task ids
+
+/////////////////////////////////////////////
+//Defaults for anything task_config.h leaves out
+#ifndef TASK_MAX_TASK
+#define TASK_MAX_TASK		8		//max number of tasks
+#endif
+
+#ifndef TASK_USE_NAMES
+#define TASK_USE_NAMES		0		//keep a name for each task
+#endif
+
+#ifndef TASK_USE_MESSAGES
+#define TASK_USE_MESSAGES	0		//message queues for tasks that attach one
+#endif
+
+#ifndef TASK_MESSAGE_SIZE
+#define TASK_MESSAGE_SIZE	8		//max messages in the msg queue, power of 2
+#endif
+
+#ifndef TASK_MESSAGE_QUEUES
+#define TASK_MESSAGE_QUEUES	TASK_MAX_TASK	//queues in the pool
+#endif
+
+#ifndef TASK_MESSAGE_WAKE
+#define TASK_MESSAGE_WAKE	0		//post makes the task ready, see below
+#endif
+
+#define NULL_PTR			((void *)0)
+#define TASK_INDEX_NONE		0xFF	//end of the timer list
+#define TASK_MESSAGE_MASK	(TASK_MESSAGE_SIZE - 1)
+
+#if (TASK_MESSAGE_SIZE & TASK_MESSAGE_MASK) || (TASK_MESSAGE_SIZE > 128)
+#error "TASK_MESSAGE_SIZE must be a power of 2, 128 max"
+#endif
+
+//ready set, one bit per task, bit 0 is index 0
+#if (TASK_MAX_TASK > 16)
+#error "TASK_MAX_TASK must be 16 or less"
+#elif (TASK_MAX_TASK > 8)
+typedef uint16_t TaskReady_t;
+#else
+typedef uint8_t TaskReady_t;
+#endif
+
+/////////////////////////////////////////////
+//Tickless idle.  Set TASK_TICKLESS to 1 and the
+//scheduler programs TACCR0 for the next task
+//timeout and sleeps until then, instead of taking
+//a timer interrupt every tick.  TASK_TICK_COUNTS
+//is the number of TimerA counts in one tick.
+//LPM3 turns off SMCLK, so TimerA has to run from
+//ACLK to use it.  ISRs that post to tasks need
+//TASK_WAKE_ON_EXIT() so the scheduler wakes up.
+#ifndef TASK_TICKLESS
+#define TASK_TICKLESS			0
+#endif
+
+#ifndef TASK_TICK_COUNTS
+#define TASK_TICK_COUNTS		2000U		//1ms, SMCLK 16mhz / 8
+#endif
+
+#ifndef TASK_TICKLESS_LPM_BITS
+#define TASK_TICKLESS_LPM_BITS	LPM0_bits	//LPM3_bits with TimerA on ACLK
+#endif
+
+#define TASK_TICKLESS_MAX		(0xFFFF / TASK_TICK_COUNTS)	//longest sleep in ticks
+
+#if TASK_TICKLESS
+#define TASK_WAKE_ON_EXIT()		__bic_SR_register_on_exit(TASK_TICKLESS_LPM_BITS)
+#else
+#define TASK_WAKE_ON_EXIT()
+#endif
+
+/////////////////////////////////////////////
+//Idle hook.  Called from the scheduler loop
+//when no task is ready and tickless is off.
+//Empty unless task_config.h defines it, the
+//host simulation in source/host/task uses it
+//to move the time on.
+#ifndef TASK_IDLE_HOOK
+#define TASK_IDLE_HOOK()
+#endif
+
+/////////////////////////////////////////////
+//Scheduling.  TASK_SCHED_PRIORITY runs the ready
+//task with the lowest index.  Give the shortest
+//period the lowest index for rate monotonic.
+//TASK_SCHED_EDF runs the ready task with the
+//earliest deadline (timeout + period), ties go to
+//the lowest index.  Both modes count missed
+//deadlines and lost periods for each task.
+#ifndef TASK_SCHED_MODE
+#define TASK_SCHED_MODE			TASK_SCHED_PRIORITY
+#endif
+
+/////////////////////////////////////////////
+//Profiling.  Set TASK_PROFILE to 1 to time each
+//task run with a free running timer, TimerA1 on
+//SMCLK / 8 (2 counts per us, wraps at 32ms).
+//Keeps the run time, the start jitter (timeout
+//to start of the run) and overruns (runs longer
+//than the task period) for each task.  Read them
+//with Task_ProfileDump().  Nothing is compiled
+//in with TASK_PROFILE set to 0.
+#ifndef TASK_PROFILE
+#define TASK_PROFILE				0
+#endif
+
+#ifndef TASK_PROFILE_TIMER
+#define TASK_PROFILE_TIMER			TA1R
+#define TASK_PROFILE_TIMER_START()	(TA1CTL = TASSEL_2 | ID_3 | MC_2 | TACLR)
+#endif
+
+
+/////////////////////////////////////////////
+//Wake on message.  Set TASK_MESSAGE_WAKE to 1
+//and a task turned on with Task_SetMessageWake()
+//is made ready as soon as a message is posted to
+//it, so it doesn't wait up to a period to see the
+//message.  It still times out at its period too.
+//The deadline is one period from the post.  When
+//tickless, an isr that posts still needs
+//TASK_WAKE_ON_EXIT() to wake the scheduler.
+
+
+#if TASK_USE_MESSAGES
+//signal is a TaskSignal_t from task_config.h,
+//kept to a byte so the queues stay small
+typedef struct
+{
+	uint8_t signal;
+#ifdef TASK_MESSAGE_VALUE_TYPE
+	TASK_MESSAGE_VALUE_TYPE value;		//generic value, can be used for anything
+#endif
+}TaskMessage;
+#endif
+
+
+#if TASK_PROFILE
+//task run stats, times in TASK_PROFILE_TIMER counts
+typedef struct
+{
+	uint16_t runMin;			//shortest run
+	uint16_t runMax;			//longest run
+	uint32_t runTotal;			//all runs added up, runTotal / runCount = average
+	uint32_t runCount;			//number of runs
+	uint16_t jitterMax;			//latest start after the timeout
+	uint32_t jitterTotal;		//all start delays added up
+	uint16_t overrun;			//runs that took the task period (1 for 0) or longer
+	uint16_t readyStamp;		//timer value at the timeout, set in the isr
+}TaskProfile;
+#endif
+
+
+
+//function prototypes
+void Task_Init(void);
+int Task_AddTask(const char* name, void (*taskFunction) (void), uint16_t time, uint8_t priority);
+int Task_RemoveTask(void (*taskFunction) (void));
+void Task_EnableTask(uint8_t taskIndex);
+void Task_DisableTask(uint8_t taskIndex);
+void Task_RescheduleTask(uint8_t taskIndex, uint16_t updatedTime);
+
+#if TASK_USE_NAMES
+int Task_GetIndexFromName(const char* name);
+#endif
+
+void Task_StartScheduler(void);
+void Task_TimerISRHandler(void);
+
+uint32_t Task_GetTickCount(void);
+uint32_t Task_GetSleepTicks(void);
+int Task_GetMissedDeadlines(uint8_t index);
+int Task_GetCoalescedPeriods(uint8_t index);
+
+#if TASK_PROFILE
+void Task_ProfileReset(void);
+void Task_ProfileDump(void (*print) (uint8_t index, const TaskProfile *profile));
+#endif
+
+#if TASK_USE_MESSAGES
+//messages
+int Task_AttachMessageQueue(uint8_t index);
+int Task_ClearAllMessages(uint8_t element);					//helper function on init/remove, etc
+int Task_SendMessage(uint8_t index, TaskMessage message);
+int Task_GetNumMessageWaiting(uint8_t index);
+int Task_GetNextMessage(uint8_t index, TaskMessage *msg);
+int Task_GetMessageOverflow(uint8_t index);
+#if TASK_MESSAGE_WAKE
+int Task_SetMessageWake(uint8_t index, uint8_t wake);
+#endif
+#endif
+
+
+
+
+#endif /* TASK_TASK_H_ */
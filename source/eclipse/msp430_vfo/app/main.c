@@ -77,7 +77,7 @@ Done, 14792 bytes total
 void dummyDelay(unsigned int delay);
 
 void delay_ms(volatile int ticks);
-void TimeDelay_Decrement(void);
+void TimeDelay_Decrement(uint16_t ticks);
 void GPIO_init(void);
 void TimerA_init(void);
 void Interrupt_init(void);
@@ -142,9 +142,11 @@ int main(void)
 
 	Task_Init();		//init the tasker
 
-	Task_AddTask("rxTask", TaskFunction_RxTask, 100, 0);
-	Task_AddTask("led", TaskFunction_LedTask, 500, 1);
-	Task_AddTask("display", TaskFunction_DisplayTask, 500, 2);
+	Task_AddTask("rxTask", TaskFunction_RxTask, 100, TASK_ID_RX);
+	Task_AddTask("led", TaskFunction_LedTask, 500, TASK_ID_LED);
+	Task_AddTask("display", TaskFunction_DisplayTask, 500, TASK_ID_DISPLAY);
+	Task_AttachMessageQueue(TASK_ID_RX);		//rx task takes all the messages
+	Task_SetMessageWake(TASK_ID_RX, 1);		//and runs right after a post
 
 	//start the tasker - should not return from
 	//this function as it's a while loop
@@ -172,12 +174,18 @@ void delay_ms(volatile int ticks)
 
 
 /////////////////////////////////////////
-//Function called from the TimerA ISR
-void TimeDelay_Decrement(void)
+//Function called from the TimerA ISR with
+//the ticks since the last one, 1 unless
+//tickless
+void TimeDelay_Decrement(uint16_t ticks)
 {
-	if (TimeDelay != 0x00)
+	if (TimeDelay > (int)ticks)
 	{
-		TimeDelay--;
+		TimeDelay -= ticks;
+	}
+	else
+	{
+		TimeDelay = 0;
 	}
 }
 
@@ -306,14 +314,30 @@ void LED_Green_Toggle(void)
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer_A(void)
 {
+#if TASK_TICKLESS
+	uint32_t start;
+#endif
+
 	//clear the timer interrupt
 	TACTL &=~ BIT0;
 
+#if TASK_TICKLESS
+	start = Task_GetTickCount();
+
+	//manage the tick for the tasker
+	Task_TimerISRHandler();
+
+	//time for delay_ms(), one interrupt is the
+	//whole period the tasker programmed
+	TimeDelay_Decrement(Task_GetTickCount() - start);
+#else
 	//time tick for delay_ms()
-	TimeDelay_Decrement();
+	TimeDelay_Decrement(1);
 
 	//manage the tick for the tasker
 	Task_TimerISRHandler();
+#endif
+	TASK_WAKE_ON_EXIT();
 }
 
 
@@ -330,13 +354,15 @@ __interrupt void Port_1(void)
 		//send message to the receiver task with
 		TaskMessage msg;
 		msg.signal = TASK_SIG_USER_BUTTON;
-		int index = Task_GetIndexFromName("rxTask");
-		Task_SendMessage(index, msg);
+		Task_SendMessage(TASK_ID_RX, msg);
 
 	}
 
 	//clear the interrupt flag - button
 	P1IFG &=~ BIT3;
+
+	//wake the tasker if it's sleeping
+	TASK_WAKE_ON_EXIT();
 }
 
 
@@ -352,7 +378,6 @@ __interrupt void Port_1(void)
 void TaskFunction_RxTask(void)
 {
 	TaskMessage msg = {TASK_SIG_NONE};
-	uint8_t index = Task_GetIndexFromName("rxTask");
 
 	/////////////////////////////////
 	//RIT switch - test P2.2 and set the led
@@ -366,7 +391,7 @@ void TaskFunction_RxTask(void)
 
 	///////////////////////////////////////
 	//read all messages in the queue
-	while (Task_GetNextMessage(index, &msg) > 0)
+	while (Task_GetNextMessage(TASK_ID_RX, &msg) > 0)
 	{
 		switch(msg.signal)
 		{
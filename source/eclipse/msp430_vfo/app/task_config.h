@@ -0,0 +1,71 @@
+/*
+ * task_config.h
+ *
+ *  Tasker settings for msp430_vfo.  Messages carry
+ *  the signal only, tasks are posted to by id so
+ *  the names are left out.  See common/task/task.h
+ *  for the options.
+ *
+ */
+
+#ifndef TASK_CONFIG_H_
+#define TASK_CONFIG_H_
+
+#define TASK_MAX_TASK		3		//max number of tasks
+#define TASK_USE_NAMES		0
+#define TASK_USE_MESSAGES	1
+#define TASK_MESSAGE_SIZE	8		//max messages in the msg queue, power of 2
+#define TASK_MESSAGE_QUEUES	1		//rx task handles all the messages
+#define TASK_MESSAGE_WAKE	1		//rx runs as soon as the encoder posts
+
+//with tickless the Timer_A isr in main.c passes
+//TimeDelay_Decrement() the ticks in the period, so
+//delay_ms() only counts down when the period ends
+#define TASK_TICKLESS		0
+#define TASK_SCHED_MODE		TASK_SCHED_PRIORITY
+#define TASK_PROFILE		0
+
+
+/////////////////////////////////
+//Task Signal IDs.  This is a generic
+//list that applies to all tasks.
+//Ideally, it would be cool to change this
+//so that each task contained a pointer
+//to a message id list.
+//
+typedef enum
+{
+	TASK_SIG_NONE,			//do nothing
+	TASK_SIG_ON,			//on
+	TASK_SIG_OFF,			//off
+	TASK_SIG_TOGGLE,		//toggle
+	TASK_SIG_ENCODER_LEFT,	//encoder left
+	TASK_SIG_ENCODER_RIGHT,	//encoder right
+	TASK_SIG_ENCODER_BUTTON,	//encoder button
+	TASK_SIG_USER_BUTTON,	//user button
+
+
+
+	TASK_SIG_LAST,		//need this one???
+
+}TaskSignal_t;
+
+
+/////////////////////////////////
+//Task IDs.  The ID is the priority passed
+//to Task_AddTask() and the index in the task
+//table, so isrs can post to a task without
+//looking it up by name.
+//
+typedef enum
+{
+	TASK_ID_RX,				//receiver task, handles all the messages
+	TASK_ID_LED,			//led blink
+	TASK_ID_DISPLAY,		//lcd update
+
+	TASK_ID_LAST,
+
+}TaskID_t;
+
+
+#endif /* TASK_CONFIG_H_ */
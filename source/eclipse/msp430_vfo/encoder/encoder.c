@@ -182,8 +182,7 @@ __interrupt void Port_2(void)
 	{
 		TaskMessage msg;
 		msg.signal = TASK_SIG_ENCODER_BUTTON;
-		int index = Task_GetIndexFromName("rxTask");
-		Task_SendMessage(index, msg);
+		Task_SendMessage(TASK_ID_RX, msg);
 
 	}
 
@@ -209,8 +208,7 @@ __interrupt void Port_2(void)
 
 		if (okFlag == 1)
 		{
-			int index = Task_GetIndexFromName("rxTask");
-			Task_SendMessage(index, msg);
+			Task_SendMessage(TASK_ID_RX, msg);
 		}
 
 	}
@@ -220,6 +218,8 @@ __interrupt void Port_2(void)
 	P2IFG &=~ ENCODER_BIT1_PIN;
 	P2IFG &=~ ENCODER_BUTTON_PIN;
 
+	//wake the tasker if it's sleeping
+	TASK_WAKE_ON_EXIT();
 }
 
 
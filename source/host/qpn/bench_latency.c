@@ -0,0 +1,212 @@
+/*
+ * bench_latency.c
+ *
+ *  Preemption latency of QK-nano against the vanilla
+ *  kernel, from the tick that posts a timeout to a high
+ *  priority active object to its dispatch, while a low
+ *  priority one runs long dispatches.  One build per
+ *  kernel, fixed tick.
+ *
+ *  high re-arms a one tick timeout each time it comes,
+ *  so it's posted on every tick, and does no work.  low
+ *  works for the dispatch length given on the command
+ *  line, in ms, then waits a pseudo random 1 to
+ *  BENCH_GAP_MAX ms on a rate 1 timeout, so its
+ *  dispatches land at every phase of the tick.  The same
+ *  sequence for both kernels.
+ *
+ *  Time is simulated (sim.h), with no cost for the isr
+ *  or the kernel, so a dispatch inside the tick isr
+ *  counts as 0.  On the launchpad add the isr entry,
+ *  QF_tickXISR() and one QK_sched_() pass to the QK-nano
+ *  numbers.  The vanilla ones are set by how much of the
+ *  low dispatch is left when the tick comes.  low
+ *  starts on a rate 1 tick, so that's at most the
+ *  dispatch less 1 ms.
+ *
+ *  Prints the ticks, how many came during a low
+ *  dispatch, and the mean and worst latency in us.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include "sim.h"
+
+#define BENCH_TICKS			20000
+#define BENCH_GAP_MAX		50			//ms
+
+#ifdef QK_PREEMPTIVE
+#define BENCH_KERNEL		"QK-nano"
+#else
+#define BENCH_KERNEL		"vanilla"
+#endif
+
+typedef struct
+{
+	QActive super;
+	uint32_t armed;				//SimTime of the last arm
+} BenchAO;
+
+static BenchAO AO_Low;
+static BenchAO AO_High;
+
+static QEvt l_lowQSto[2];
+static QEvt l_highQSto[2];
+
+QActiveCB const Q_ROM QF_active[] = {
+	{ (QActive *)0,				(QEvt *)0,		0U					},
+	{ (QActive *)&AO_Low,		l_lowQSto,		Q_DIM(l_lowQSto)	},
+	{ (QActive *)&AO_High,		l_highQSto,		Q_DIM(l_highQSto)	}
+};
+
+Q_ASSERT_COMPILE(QF_MAX_ACTIVE == Q_DIM(QF_active) - 1);
+
+static uint32_t BenchLowCounts;
+static uint32_t BenchCountsPerMs;
+static uint32_t BenchSeed = 1;
+static uint32_t BenchLowEnd = 0;			//SimTime low's dispatch ends
+static uint32_t BenchTicks = 0;
+static uint32_t BenchHeld = 0;
+static uint64_t BenchTotal = 0;
+static uint32_t BenchMax = 0;
+
+static void Bench_ctor(void);
+static QState Bench_initial(BenchAO* const me);
+static QState Bench_high(BenchAO* const me);
+static QState Bench_low(BenchAO* const me);
+static uint16_t Bench_gap(void);
+
+
+int main(int argc, char* argv[])
+{
+	uint32_t ms = (argc > 1) ? (uint32_t)atoi(argv[1]) : 40;
+
+	BenchLowCounts = ms;			//ms until the clock is known
+	Sim_Main(BENCH_TICKS, Bench_ctor);
+
+	printf("%s, low dispatch %2lu ms: %lu ticks, %lu during low, mean %7.1f us, max %6.0f us\n",
+			BENCH_KERNEL, (unsigned long)ms, (unsigned long)BenchTicks, (unsigned long)BenchHeld,
+			BenchTicks ? (double)BenchTotal * 1000 / BenchCountsPerMs / BenchTicks : 0.0,
+			(double)BenchMax * 1000 / BenchCountsPerMs);
+
+	return 0;
+}
+
+
+static void Bench_ctor(void)
+{
+	BenchCountsPerMs = SimTickCounts * BSP_TICKS_PER_SEC / 1000;
+	BenchLowCounts *= BenchCountsPerMs;
+
+	QActive_ctor(&AO_Low.super, Q_STATE_CAST(&Bench_initial));
+	QActive_ctor(&AO_High.super, Q_STATE_CAST(&Bench_initial));
+}
+
+
+static QState Bench_initial(BenchAO* const me)
+{
+	if (me == &AO_High)
+		return Q_TRAN(&Bench_high);
+
+	return Q_TRAN(&Bench_low);
+}
+
+
+//////////////////////////////////////////////
+//Bench_high
+//The timeout was posted on the boundary after
+//the arm.
+static QState Bench_high(BenchAO* const me)
+{
+	QState status;
+	uint32_t due;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			me->armed = SimTime;
+			QActive_armX((QActive *)me, 0U, 1U);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT_SIG:
+		{
+			due = (me->armed / SimTickCounts + 1) * SimTickCounts;
+
+			BenchTicks++;
+			BenchTotal += SimTime - due;
+
+			if (SimTime - due > BenchMax)
+				BenchMax = SimTime - due;
+
+			if (BenchLowEnd > due)
+				BenchHeld++;
+
+			me->armed = SimTime;
+			QActive_armX((QActive *)me, 0U, 1U);
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+static QState Bench_low(BenchAO* const me)
+{
+	QState status;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			QActive_armX((QActive *)me, 1U, Bench_gap());
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT1_SIG:
+		{
+			BenchLowEnd = SimTime + BenchLowCounts;
+			Sim_Busy(BenchLowCounts);
+			BenchLowEnd = SimTime;
+
+			QActive_armX((QActive *)me, 1U, Bench_gap());
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+//////////////////////////////////////////////
+//Bench_gap
+//1 to BENCH_GAP_MAX ms, a plain LCG.
+static uint16_t Bench_gap(void)
+{
+	BenchSeed = BenchSeed * 1103515245UL + 12345UL;
+
+	return (uint16_t)(1 + (BenchSeed >> 16) % BENCH_GAP_MAX);
+}
@@ -0,0 +1,21 @@
+/*
+ * intrinsics.h
+ *
+ *  Host stand-in for the TI compiler intrinsics the
+ *  QP-nano port and bsp.c use.  They work on the fake
+ *  status register in sim.c, see sim.h.
+ *
+ */
+
+#ifndef HOST_INTRINSICS_H_
+#define HOST_INTRINSICS_H_
+
+#include "sim.h"
+
+#define __disable_interrupt()			(SimSR &= ~GIE)
+#define __enable_interrupt()			Sim_Enable()
+#define __low_power_mode_1()			Sim_Sleep(LPM1_bits)
+#define __low_power_mode_3()			Sim_Sleep(LPM3_bits)
+#define __low_power_mode_off_on_exit()	Sim_WakeOnExit()
+
+#endif /* HOST_INTRINSICS_H_ */
@@ -0,0 +1,86 @@
+/*
+ * msp430g2553.h
+ *
+ *  Host stand-in for the TI header when bsp.c is built
+ *  on a host.  The registers bsp.c touches are plain
+ *  variables in sim.c, except TAR and TAIV, which are
+ *  reads that sim.c answers from the simulated Timer_A,
+ *  and the trace uart registers (Q_SPY), which go to
+ *  the simulated USCI_A0.
+ *  -I. has to come before the system includes for this
+ *  one to be picked up.
+ *
+ */
+
+#ifndef HOST_MSP430G2553_H_
+#define HOST_MSP430G2553_H_
+
+#include <stdint.h>
+
+#include "sim.h"
+
+#define __interrupt
+
+#define BIT0			0x0001
+#define BIT1			0x0002
+#define BIT2			0x0004
+#define BIT3			0x0008
+#define BIT4			0x0010
+#define BIT5			0x0020
+#define BIT6			0x0040
+#define BIT7			0x0080
+
+#define WDTPW			0x5A00
+#define WDTHOLD			0x0080
+#define LFXT1S_2		0x0020
+
+//Timer_A
+#define TASSEL_1		0x0100
+#define TASSEL_2		0x0200
+#define MC_2			0x0020
+#define TACLR			0x0004
+#define CCIE			0x0010
+#define CCIFG			0x0001
+#define TA0IV_TACCR1	0x0002
+
+#define TAR				(Sim_TimerRead())
+#define TAIV			(Sim_TimerVector())
+
+//basic clock, the 1 MHz calibration for Q_SPY
+#define CALBC1_1MHZ		(SimCalBc1)
+#define CALDCO_1MHZ		(SimCalDco)
+
+//USCI_A0, the Q_SPY trace uart.  IFG2 and
+//UCA0STAT reads and UCA0TXBUF writes go to
+//the simulated uart in sim.c
+#define UCSWRST			0x01
+#define UCSSEL_2		0x80
+#define UCBUSY			0x01
+#define UCA0TXIFG		0x02
+
+#define IFG2			(Sim_UartFlags())
+#define UCA0STAT		(Sim_UartStatus())
+#define UCA0TXBUF		(*Sim_UartTx())
+
+extern volatile uint16_t WDTCTL;
+extern volatile uint8_t BCSCTL3;
+extern volatile uint8_t P1DIR;
+extern volatile uint8_t P1OUT;
+extern volatile uint8_t P1REN;
+extern volatile uint8_t P1SEL;
+extern volatile uint8_t P1SEL2;
+extern volatile uint8_t BCSCTL1;
+extern volatile uint8_t DCOCTL;
+extern const volatile uint8_t SimCalBc1;
+extern const volatile uint8_t SimCalDco;
+extern volatile uint8_t UCA0CTL1;
+extern volatile uint8_t UCA0BR0;
+extern volatile uint8_t UCA0BR1;
+extern volatile uint8_t UCA0MCTL;
+extern volatile uint16_t TACTL;
+extern volatile uint16_t CCTL0;
+extern volatile uint16_t CCTL1;
+extern volatile uint16_t CCR0;
+extern volatile uint16_t CCR1;
+
+#endif /* HOST_MSP430G2553_H_ */
@@ -0,0 +1,53 @@
+/*
+ * qpn_port.h
+ *
+ *  Host stand-in for the QP-nano port in
+ *  ccs/msp430_qpn_Blink1/qpn.  The settings are the
+ *  launchpad's, except the kernel: the Makefile
+ *  defines QK_PREEMPTIVE for the QK-nano builds and
+ *  leaves it out for the vanilla ones.  It's forced in
+ *  with -include, so the qpn sources skip their own
+ *  copy next to them (same include guard).
+ *
+ */
+
+#ifndef qpn_port_h
+#define qpn_port_h
+
+#define Q_NMSM
+#define Q_NFSM
+
+#define Q_PARAM_SIZE            4
+#define QF_TIMEEVT_CTR_SIZE     2
+#define QF_MAX_TICK_RATE        2
+#define QF_MAX_ACTIVE           2
+
+#define QF_INT_DISABLE()        __disable_interrupt()
+#define QF_INT_ENABLE()         __enable_interrupt()
+
+#ifdef QK_PREEMPTIVE
+#define QK_ISR_ENTRY()          ((void)0)
+#define QK_ISR_EXIT()           do { \
+    uint_fast8_t p_ = QK_schedPrio_(); \
+    if (p_ != (uint_fast8_t)0) { \
+        QK_sched_(p_); \
+    } \
+} while (0)
+#else
+#define QK_ISR_ENTRY()          ((void)0)
+#define QK_ISR_EXIT()           ((void)0)
+#endif
+
+#include <intrinsics.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qepn.h"
+#include "qfn.h"
+#include "qsn.h"
+#ifdef QK_PREEMPTIVE
+#include "qkn.h"
+#endif
+#include "qassert.h"
+
+#endif /* qpn_port_h */
@@ -0,0 +1,329 @@
+/*
+ * sim.c
+ *
+ *  Host side of the QP-nano builds, see sim.h.
+ *
+ *  With BSP_TICKLESS the timer runs from ACLK, which
+ *  isn't synchronous to MCLK, and a TAR read can catch
+ *  it between counts.  Every SIM_TEAR_EVERY read comes
+ *  back with bit 8 flipped to stand for that, so bsp.c
+ *  has to read it until two reads agree.  From SMCLK
+ *  the reads are always clean.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include <msp430g2553.h>
+#include "sim.h"
+
+#define SIM_TEAR_EVERY		4
+#define SIM_UART_BAUD		9600UL		//BSP_QS_BAUD
+
+//the isrs in bsp.c
+void timerA_ISR(void);
+void timerA1_ISR(void);
+
+//////////////////////////////////////////
+//Fake registers for msp430g2553.h
+volatile uint16_t WDTCTL = 0;
+volatile uint8_t BCSCTL3 = 0;
+volatile uint8_t P1DIR = 0;
+volatile uint8_t P1OUT = 0;
+volatile uint8_t P1REN = 0;
+volatile uint8_t P1SEL = 0;
+volatile uint8_t P1SEL2 = 0;
+volatile uint8_t BCSCTL1 = 0;
+volatile uint8_t DCOCTL = 0;
+const volatile uint8_t SimCalBc1 = 0x86;
+const volatile uint8_t SimCalDco = 0xB5;
+volatile uint8_t UCA0CTL1 = 0;
+volatile uint8_t UCA0BR0 = 0;
+volatile uint8_t UCA0BR1 = 0;
+volatile uint8_t UCA0MCTL = 0;
+volatile uint16_t TACTL = 0;
+volatile uint16_t CCTL0 = 0;
+volatile uint16_t CCTL1 = 0;
+volatile uint16_t CCR0 = 0;
+volatile uint16_t CCR1 = 0;
+
+volatile uint16_t SimSR = 0;
+uint32_t SimTime = 0;
+uint32_t SimTickCounts = 0;
+uint32_t SimIsrs = 0;
+uint32_t SimWakes = 0;
+uint32_t SimTick1Isrs = 0;
+uint32_t SimTornReads = 0;
+uint8_t SimUartOut[SIM_UART_SIZE];
+uint32_t SimUartCount = 0;
+
+static jmp_buf SimExit;
+static uint32_t SimEnd;
+#if BSP_TICKLESS
+static uint32_t SimReads = 0;
+#endif
+static uint16_t* SimFrame = NULL;	//SR stacked by the isr that's running
+static uint32_t SimUartDone = 0;	//SimTime the last byte is out
+
+static uint32_t Sim_Step(uint32_t limit);
+static void Sim_Pending(void);
+static void Sim_Interrupt(void (*isr)(void));
+
+//the lcd isn't simulated
+void SPIA_init(void) {}
+void LCD_init(void) {}
+
+
+///////////////////////////////////////////
+//Sim_Main
+//Start the board, run QF_run() for ticks
+//rate 0 ticks and come back.  ctor sets up
+//the active objects, like main() does.
+//
+void Sim_Main(uint32_t ticks, void (*ctor)(void))
+{
+	BSP_init();
+
+	SimTickCounts = CCR0;			//BSP_init() sets it to one tick
+	SimEnd = ticks * SimTickCounts;
+
+	ctor();
+
+	if (setjmp(SimExit) == 0)
+		QF_run();
+}
+
+
+///////////////////////////////////////////
+//Sim_Busy
+//An active object working for counts.
+//Interrupts are taken on the way if it has
+//them enabled.
+//
+void Sim_Busy(uint32_t counts)
+{
+	while (counts)
+		counts -= Sim_Step(counts);
+}
+
+
+///////////////////////////////////////////
+//Sim_Enable
+//__enable_interrupt(), takes anything that
+//was waiting for GIE.
+//
+void Sim_Enable(void)
+{
+	SimSR |= GIE;
+	Sim_Pending();
+}
+
+
+///////////////////////////////////////////
+//Sim_Sleep
+//__low_power_mode_x(), sets GIE and the low
+//power bits and moves time on until an isr
+//clears them in the stacked SR.
+//
+void Sim_Sleep(uint16_t bits)
+{
+	SimSR |= GIE | bits;
+	Sim_Pending();
+
+	while (SimSR & CPUOFF)
+		Sim_Step(0x10000UL);
+}
+
+
+///////////////////////////////////////////
+//Sim_WakeOnExit
+//__low_power_mode_off_on_exit(), clears the
+//low power bits the isr will return to.
+//
+void Sim_WakeOnExit(void)
+{
+	if (SimFrame != NULL)
+		*SimFrame &= ~LPM3_bits;
+}
+
+
+///////////////////////////////////////////
+//Sim_TimerRead
+//TAR.
+//
+uint16_t Sim_TimerRead(void)
+{
+	uint16_t t = (uint16_t)SimTime;
+
+#if BSP_TICKLESS
+	if (++SimReads % SIM_TEAR_EVERY == 0)
+	{
+		SimTornReads++;
+		t ^= 0x0100;
+	}
+#endif
+
+	return t;
+}
+
+
+///////////////////////////////////////////
+//Sim_TimerVector
+//TAIV, the CCR1 flag is the only one used.
+//Reading it clears the flag.
+//
+uint16_t Sim_TimerVector(void)
+{
+	if (CCTL1 & CCIFG)
+	{
+		CCTL1 &= ~CCIFG;
+		return TA0IV_TACCR1;
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////
+//Sim_UartFlags
+//IFG2, UCA0TXIFG once the last byte is out.
+//The idle polls it with interrupts off, so
+//time moves on to the end of the byte or the
+//next compare match, the interrupts wait for
+//the idle to turn them back on.
+//
+uint16_t Sim_UartFlags(void)
+{
+	if (SimTime < SimUartDone)
+		Sim_Step(SimUartDone - SimTime);
+
+	return (SimTime >= SimUartDone) ? UCA0TXIFG : 0;
+}
+
+
+///////////////////////////////////////////
+//Sim_UartStatus
+//UCA0STAT, UCBUSY while a byte is going out.
+//
+uint16_t Sim_UartStatus(void)
+{
+	return (SimTime < SimUartDone) ? UCBUSY : 0;
+}
+
+
+///////////////////////////////////////////
+//Sim_UartTx
+//UCA0TXBUF, only ever written.  Starts a byte
+//and returns where it goes in SimUartOut[].
+//
+volatile uint8_t* Sim_UartTx(void)
+{
+	static uint8_t spill;
+	uint32_t counts = (SimTickCounts * BSP_TICKS_PER_SEC * 10UL + SIM_UART_BAUD / 2) / SIM_UART_BAUD;
+
+	SimUartDone = SimTime + counts;
+
+	if (SimUartCount == SIM_UART_SIZE)
+		return &spill;
+
+	return &SimUartOut[SimUartCount++];
+}
+
+
+///////////////////////////////////////////
+//Sim_Step
+//Move time on to the next compare match, or
+//by limit if that's sooner.  Sets the flags
+//that match and takes the interrupts.  Ends
+//the run at SimEnd.  Returns the counts.
+//
+static uint32_t Sim_Step(uint32_t limit)
+{
+	uint16_t tar = (uint16_t)SimTime;
+	uint32_t to0 = (uint16_t)(CCR0 - tar);
+	uint32_t to1 = (uint16_t)(CCR1 - tar);
+	uint32_t step;
+
+	//equal now means it matched on the way
+	//here, the next match is a wrap away
+	if (to0 == 0)
+		to0 = 0x10000UL;
+
+	if (to1 == 0)
+		to1 = 0x10000UL;
+
+	step = (to0 < to1) ? to0 : to1;
+
+	if (step > limit)
+		step = limit;
+
+	if (SimTime + step >= SimEnd)
+		longjmp(SimExit, 1);
+
+	SimTime += step;
+
+	if ((uint16_t)SimTime == CCR0)
+		CCTL0 |= CCIFG;
+
+	if ((uint16_t)SimTime == CCR1)
+		CCTL1 |= CCIFG;
+
+	Sim_Pending();
+
+	return step;
+}
+
+
+///////////////////////////////////////////
+//Sim_Pending
+//Take the enabled interrupts that are set,
+//CCR0 first, it has the higher priority.
+//
+static void Sim_Pending(void)
+{
+	while (SimSR & GIE)
+	{
+		if ((CCTL0 & (CCIE | CCIFG)) == (CCIE | CCIFG))
+		{
+			CCTL0 &= ~CCIFG;		//cleared when the cpu takes it
+			Sim_Interrupt(timerA_ISR);
+		}
+		else if ((CCTL1 & (CCIE | CCIFG)) == (CCIE | CCIFG))
+		{
+			SimTick1Isrs++;
+			Sim_Interrupt(timerA1_ISR);
+		}
+		else
+			break;
+	}
+}
+
+
+///////////////////////////////////////////
+//Sim_Interrupt
+//Stack the SR, clear it, run the isr and
+//put back what's on the stack, like the
+//cpu does.  A wake if it was asleep.
+//
+static void Sim_Interrupt(void (*isr)(void))
+{
+	uint16_t sr = SimSR;
+	uint16_t* frame = SimFrame;
+
+	SimIsrs++;
+
+	if (sr & CPUOFF)
+		SimWakes++;
+
+	SimFrame = &sr;
+	SimSR = 0;
+
+	isr();
+
+	SimFrame = frame;
+	SimSR = sr;
+}
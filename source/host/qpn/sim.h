@@ -0,0 +1,58 @@
+/*
+ * sim.h
+ *
+ *  Host side of the QP-nano builds.  A simulated
+ *  Timer_A, status register and low power modes for
+ *  bsp.c and the QP-nano kernels to run on.
+ *
+ *  Time is counts of the timer clock and only moves
+ *  when an active object calls Sim_Busy() or the idle
+ *  sleeps, so the numbers come out the same on every
+ *  host.  The compare interrupts are taken as soon as
+ *  TAR gets to CCR0 or CCR1 with GIE set, nested when a
+ *  QK-nano dispatch inside an isr turns GIE back on.
+ *
+ *  The trace uart (Q_SPY) sends a byte in the counts
+ *  10 bits take at SIM_UART_BAUD, waiting for it moves
+ *  time on like the cpu polling the flag would.
+ *
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+
+//status register bits
+#define GIE				0x0008
+#define CPUOFF			0x0010
+#define SCG0			0x0040
+#define SCG1			0x0080
+#define LPM1_bits		(SCG0 | CPUOFF)
+#define LPM3_bits		(SCG1 | SCG0 | CPUOFF)
+
+extern volatile uint16_t SimSR;
+extern uint32_t SimTime;			//timer counts since BSP_init()
+extern uint32_t SimTickCounts;		//counts per rate 0 tick, from BSP_init()
+extern uint32_t SimIsrs;			//compare interrupts taken
+extern uint32_t SimWakes;			//of them, taken in a low power mode
+extern uint32_t SimTick1Isrs;		//of them, CCR1
+extern uint32_t SimTornReads;		//TAR reads that came back torn
+
+#define SIM_UART_SIZE		16384		//bytes kept from the trace uart
+extern uint8_t SimUartOut[SIM_UART_SIZE];	//bytes sent out USCI_A0 (Q_SPY)
+extern uint32_t SimUartCount;
+
+void Sim_Main(uint32_t ticks, void (*ctor)(void));
+void Sim_Busy(uint32_t counts);
+
+void Sim_Enable(void);
+void Sim_Sleep(uint16_t bits);
+void Sim_WakeOnExit(void);
+uint16_t Sim_TimerRead(void);
+uint16_t Sim_TimerVector(void);
+uint16_t Sim_UartFlags(void);
+uint16_t Sim_UartStatus(void);
+volatile uint8_t* Sim_UartTx(void);
+
+#endif /* HOST_SIM_H_ */
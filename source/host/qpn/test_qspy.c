@@ -0,0 +1,245 @@
+/*
+ * test_qspy.c
+ *
+ *  The QS-nano trace (Q_SPY) through the real qsn.c and
+ *  the drain in bsp.c's idle, one build for each of
+ *  QK-nano and vanilla.  Writes the bytes that went out
+ *  the uart and a list of every record the kernel asked
+ *  for, test_qspy.py decodes the bytes with qspy_nano.py
+ *  and checks them against the list.
+ *
+ *  Spy times out every TEST_PERIOD ticks and takes
+ *  turns at:
+ *  - posting signals 0x7E and 0x7D to Echo, so the post
+ *    and dispatch records carry a flag and an escape
+ *  - a record with 0x7E and 0x7D in the signal, data and
+ *    timestamp, written when TAR gets to TEST_ESC_TIME
+ *  - a burst of QS_RING_LEN + TEST_BURST_OVER records,
+ *    more than the ring holds, so some are dropped and
+ *    the host sees a gap in the sequence numbers
+ *
+ *  QS_rec_() is wrapped by the linker (--wrap) to keep
+ *  the list.  The timestamp is TAR, SimTime in the fixed
+ *  tick build, so the list has it too.
+ *
+ *  usage: test_qspy_xx trace.bin records.txt
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include "sim.h"
+
+#define TEST_TICKS			60
+#define TEST_PERIOD			4			//ticks between Spy's turns
+#define TEST_ESC_DATA		0x7D7E
+#define TEST_ESC_TIME		0x7E7D
+#define TEST_BURST_OVER		4
+
+#ifdef QK_PREEMPTIVE
+#define TEST_KERNEL			"QK-nano"
+#else
+#define TEST_KERNEL			"vanilla"
+#endif
+
+enum
+{
+	TEST_FLAG_SIG = 0x7E,		//user signals that need escaping
+	TEST_ESCAPE_SIG = 0x7D,
+};
+
+typedef struct
+{
+	QActive super;
+	uint8_t turn;
+} TestSpy;
+
+typedef struct
+{
+	QActive super;
+	uint32_t events;
+} TestEcho;
+
+static TestSpy AO_Spy;
+static TestEcho AO_Echo;
+
+static QEvt l_spyQSto[2];
+static QEvt l_echoQSto[4];
+
+QActiveCB const Q_ROM QF_active[] = {
+	{ (QActive *)0,				(QEvt *)0,		0U					},
+	{ (QActive *)&AO_Spy,		l_spyQSto,		Q_DIM(l_spyQSto)	},
+	{ (QActive *)&AO_Echo,		l_echoQSto,		Q_DIM(l_echoQSto)	}
+};
+
+Q_ASSERT_COMPILE(QF_MAX_ACTIVE == Q_DIM(QF_active) - 1);
+
+static FILE* TestRecords;
+static uint32_t TestCount = 0;
+
+void __real_QS_rec_(uint_fast8_t type, uint_fast8_t prio, uint_fast8_t sig, uint16_t data);
+void __wrap_QS_rec_(uint_fast8_t type, uint_fast8_t prio, uint_fast8_t sig, uint16_t data);
+
+static void Test_ctor(void);
+static QState Test_spyInitial(TestSpy* const me);
+static QState Test_spyActive(TestSpy* const me);
+static QState Test_echoInitial(TestEcho* const me);
+static QState Test_echoActive(TestEcho* const me);
+
+
+int main(int argc, char* argv[])
+{
+	FILE* trace;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s trace.bin records.txt\n", argv[0]);
+		return 1;
+	}
+
+	TestRecords = fopen(argv[2], "w");
+	trace = fopen(argv[1], "wb");
+
+	if ((TestRecords == NULL) || (trace == NULL))
+	{
+		perror("test_qspy");
+		return 1;
+	}
+
+	Sim_Main(TEST_TICKS, Test_ctor);
+
+	fwrite(SimUartOut, 1, SimUartCount, trace);
+	fclose(trace);
+	fclose(TestRecords);
+
+	printf("QS-nano trace, %s, %u ticks of %lu counts: %lu records, %lu bytes out the uart\n",
+			TEST_KERNEL, TEST_TICKS, (unsigned long)SimTickCounts,
+			(unsigned long)TestCount, (unsigned long)SimUartCount);
+
+	//the uart buffer filling up would look
+	//like lost records
+	if (SimUartCount == SIM_UART_SIZE)
+	{
+		printf("uart buffer full\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+
+//////////////////////////////////////////////
+//__wrap_QS_rec_
+//Every record the kernel or Spy writes, with
+//the sequence number qsn.c gives it, kept or
+//dropped.  Called with interrupts disabled.
+void __wrap_QS_rec_(uint_fast8_t type, uint_fast8_t prio, uint_fast8_t sig, uint16_t data)
+{
+	fprintf(TestRecords, "%lu %u %u %u %u %u\n", (unsigned long)(TestCount & 0xFFU),
+			(unsigned)type, (unsigned)prio, (unsigned)sig, (unsigned)data,
+			(unsigned)(uint16_t)SimTime);
+	TestCount++;
+
+	__real_QS_rec_(type, prio, sig, data);
+}
+
+
+static void Test_ctor(void)
+{
+	QActive_ctor(&AO_Spy.super, Q_STATE_CAST(&Test_spyInitial));
+	QActive_ctor(&AO_Echo.super, Q_STATE_CAST(&Test_echoInitial));
+}
+
+
+static QState Test_spyInitial(TestSpy* const me)
+{
+	return Q_TRAN(&Test_spyActive);
+}
+
+
+static QState Test_spyActive(TestSpy* const me)
+{
+	QState status;
+	uint8_t i;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			QActive_armX((QActive *)me, 0U, TEST_PERIOD);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT_SIG:
+		{
+			QActive_armX((QActive *)me, 0U, TEST_PERIOD);
+
+			switch (me->turn++ % 3U)
+			{
+				case 0:
+					QACTIVE_POST((QActive *)&AO_Echo, TEST_FLAG_SIG, 0U);
+					QACTIVE_POST((QActive *)&AO_Echo, TEST_ESCAPE_SIG, 0U);
+					break;
+
+				case 1:
+					//TAR wraps every 65536 counts, work
+					//until it gets to the time
+					Sim_Busy((uint16_t)(TEST_ESC_TIME - (uint16_t)SimTime));
+					QS_REC_CRIT_(QS_QEP_TRAN, 0U, TEST_FLAG_SIG, TEST_ESC_DATA);
+					break;
+
+				default:
+					for (i = 0 ; i < QS_RING_LEN + TEST_BURST_OVER ; i++)
+						QS_REC_CRIT_(QS_QEP_TRAN, 0U, i, i);
+					break;
+			}
+
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+static QState Test_echoInitial(TestEcho* const me)
+{
+	return Q_TRAN(&Test_echoActive);
+}
+
+
+static QState Test_echoActive(TestEcho* const me)
+{
+	QState status;
+
+	switch (Q_SIG(me))
+	{
+		case TEST_FLAG_SIG:
+		case TEST_ESCAPE_SIG:
+		{
+			me->events++;
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# test_qspy.py
+#
+# Round trip of the QS-nano trace.  Runs a test_qspy
+# build, which writes the bytes the target sent out the
+# uart and the list of every record it was asked for,
+# decodes the bytes with ../qspy_nano/qspy_nano.py and
+# checks them against the list:
+#
+# - every frame decodes to the record with its sequence
+#   number, field for field, including the ones with
+#   0x7E and 0x7D in the signal, data and timestamp
+# - the records the full ring dropped are exactly the
+#   decoder's lost count, and there are some
+# - a frame with a bad checksum is thrown out, counted
+#   once, and only costs its own record
+#
+# usage: test_qspy.py ./test_qspy_qk
+#
+
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+QSPY = os.path.join(HERE, "..", "qspy_nano", "qspy_nano.py")
+sys.path.insert(0, os.path.dirname(QSPY))
+sys.dont_write_bytecode = True  # no __pycache__ next to the decoder
+
+import qspy_nano  # noqa: E402
+
+ESC_SIG = 0x7E          # keep in sync with test_qspy.c
+ESC_DATA = 0x7D7E
+ESC_TIME = 0x7E7D
+
+
+def load(path):
+    with open(path) as f:
+        return [tuple(int(x) for x in line.split()) for line in f]
+
+
+def fields(rec):
+    # same order as the list: seq type prio sig data time
+    return (rec[0], rec[1], rec[2], rec[3], rec[4] | (rec[5] << 8), rec[6] | (rec[7] << 8))
+
+
+###########################################
+# Match
+# Walk the list along with the decoded records.
+# Returns (errors, records matched, records missing
+# between the first and the last one decoded).
+def match(expected, recs):
+    errors = []
+    index = 0
+    missing = 0
+    matched = []
+    for rec in recs:
+        got = fields(rec)
+        start = index
+        while index < len(expected) and expected[index][0] != got[0]:
+            index += 1
+        if index == len(expected):
+            errors.append("seq %d not in the list" % got[0])
+            index = start
+            continue
+        if matched:
+            missing += index - start
+        if expected[index] != got:
+            errors.append("record %d is %s, expected %s" % (index, got, expected[index]))
+        matched.append(expected[index])
+        index += 1
+    return errors, matched, missing
+
+
+def decode(data):
+    decoder = qspy_nano.Decoder(1000000.0, {}, {}, True)
+    recs = []
+    for rec in qspy_nano.frames([data]):
+        decoder.record(rec)
+        if rec is not None:
+            recs.append(rec)
+    return decoder, recs
+
+
+###########################################
+# Corrupt
+# Flip a bit in the checksum of a frame in the
+# middle, one that isn't escaped and doesn't turn
+# into a flag or an escape.
+def corrupt(data):
+    ends = [i for i, b in enumerate(data) if b == qspy_nano.FRAME]
+    for end in ends[len(ends) // 2:]:
+        chk = end - 1
+        if data[chk - 1] != qspy_nano.ESC and data[chk] ^ 1 not in (qspy_nano.FRAME, qspy_nano.ESC):
+            bad = bytearray(data)
+            bad[chk] ^= 1
+            return bytes(bad)
+    return None
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("usage: %s ./test_qspy_xx" % sys.argv[0])
+        return 1
+    errors = []
+
+    with tempfile.TemporaryDirectory() as tmp:
+        trace = os.path.join(tmp, "trace.bin")
+        listing = os.path.join(tmp, "records.txt")
+        if subprocess.call([sys.argv[1], trace, listing]) != 0:
+            print("FAIL")
+            return 1
+        with open(trace, "rb") as f:
+            data = f.read()
+        expected = load(listing)
+
+        # clean stream
+        decoder, recs = decode(data)
+        errs, matched, missing = match(expected, recs)
+        errors += errs
+        if decoder.bad != 0:
+            errors.append("%d bad frames in the clean trace" % decoder.bad)
+        if decoder.lost != missing:
+            errors.append("decoder lost %d, the ring dropped %d" % (decoder.lost, missing))
+        if missing == 0:
+            errors.append("the ring never overflowed")
+        if not any(r[3] == ESC_SIG and r[4] == ESC_DATA and r[5] == ESC_TIME for r in matched):
+            errors.append("no record with escapes in the signal, data and timestamp")
+        for sig in (qspy_nano.FRAME, qspy_nano.ESC):
+            if not any(r[1] == qspy_nano.QS_QF_POST and r[3] == sig for r in matched):
+                errors.append("no post of signal 0x%02X" % sig)
+        print("%d records, %d decoded, %d dropped by the ring, %d still in it at the end"
+              % (len(expected), len(recs), missing, len(expected) - len(recs) - missing))
+
+        # one bad checksum
+        bad = corrupt(data)
+        if bad is None:
+            errors.append("no frame to corrupt")
+        else:
+            decoder, recs = decode(bad)
+            errs, _, _ = match(expected, recs)
+            errors += errs
+            if decoder.bad != 1:
+                errors.append("bad checksum: %d bad frames" % decoder.bad)
+            if len(recs) != len(matched) - 1 or decoder.lost != missing + 1:
+                errors.append("bad checksum: %d decoded, %d lost" % (len(recs), decoder.lost))
+
+            # and the same through the command line
+            with open(trace, "wb") as f:
+                f.write(bad)
+            out = subprocess.run([sys.executable, QSPY, "--file", trace, "--quiet"],
+                                 stdout=subprocess.PIPE, universal_newlines=True).stdout
+            line = "records lost %d, bad frames 1" % (missing + 1)
+            if line not in out:
+                errors.append("qspy_nano.py didn't print '%s'" % line)
+
+    for e in errors:
+        print("  " + e)
+    print("FAIL" if errors else "PASS")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,209 @@
+/*
+ * test_rate1.c
+ *
+ *  The rate 1 tick on CCR1 through the real bsp.c and
+ *  QP-nano kernel, one build for each of QK-nano and
+ *  vanilla, fixed tick and tickless.
+ *
+ *  Two active objects arm a rate 1 timeout from their
+ *  rate 0 one: a every TEST_A_PERIOD ticks for
+ *  TEST_A_FINE rate 1 ticks, b every TEST_B_PERIOD for
+ *  TEST_B_FINE, so some of the arms overlap.  The idle
+ *  starts the rate 1 tick one period from the arm when
+ *  it's stopped, so the timeout has to come exactly
+ *  that many periods later.  If the other one has it
+ *  running it can come up to a period sooner.  The tick
+ *  has to be stopped again by the next rate 0 timeout,
+ *  and there can't be more CCR1 interrupts than the
+ *  arms asked for.
+ *
+ *  Time is simulated (sim.h), so the counts are the
+ *  same on every host.  Prints the timeouts and the
+ *  CCR1 interrupts, and PASS or FAIL.  Exits with 1 on
+ *  a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include <msp430g2553.h>
+#include "sim.h"
+
+#define TEST_TICKS			60
+#define TEST_A_PERIOD		2
+#define TEST_A_FINE			3
+#define TEST_B_PERIOD		3
+#define TEST_B_FINE			5
+
+#ifdef QK_PREEMPTIVE
+#define TEST_KERNEL			"QK-nano"
+#else
+#define TEST_KERNEL			"vanilla"
+#endif
+
+typedef struct
+{
+	QActive super;
+	const char* name;
+	uint16_t period;			//rate 0 ticks
+	uint16_t fine;				//rate 1 ticks
+	uint32_t armed;				//SimTime of the last rate 1 arm
+	uint8_t running;			//the rate 1 tick was on at the arm
+	uint32_t arms;
+	uint32_t timeouts;
+	uint32_t errors;
+} TestAO;
+
+static TestAO AO_A;
+static TestAO AO_B;
+
+static QEvt l_aQSto[2];
+static QEvt l_bQSto[2];
+
+QActiveCB const Q_ROM QF_active[] = {
+	{ (QActive *)0,				(QEvt *)0,		0U				},
+	{ (QActive *)&AO_B,			l_bQSto,		Q_DIM(l_bQSto)	},
+	{ (QActive *)&AO_A,			l_aQSto,		Q_DIM(l_aQSto)	}
+};
+
+Q_ASSERT_COMPILE(QF_MAX_ACTIVE == Q_DIM(QF_active) - 1);
+
+static uint32_t TestTick1Counts;
+
+static void Test_ctor(void);
+static void Test_aoCtor(TestAO* me, const char* name, uint16_t period, uint16_t fine);
+static QState Test_initial(TestAO* const me);
+static QState Test_active(TestAO* const me);
+static void Test_print(TestAO* me);
+
+
+int main(void)
+{
+	uint32_t errors;
+	uint32_t most;
+
+	Sim_Main(TEST_TICKS, Test_ctor);
+
+	printf("rate 1 timeouts, %s, %s, %u ticks, rate 1 every %lu counts\n", TEST_KERNEL,
+			BSP_TICKLESS ? "tickless" : "fixed tick", TEST_TICKS, (unsigned long)TestTick1Counts);
+	printf("ao  period  fine  arms  timeouts  errors\n");
+
+	Test_print(&AO_A);
+	Test_print(&AO_B);
+
+	errors = AO_A.errors + AO_B.errors;
+	most = AO_A.arms * AO_A.fine + AO_B.arms * AO_B.fine;
+
+	printf("CCR1 isrs %lu, at most %lu\n", (unsigned long)SimTick1Isrs, (unsigned long)most);
+
+	if (SimTick1Isrs > most)
+		errors++;
+
+	printf("%s\n", errors ? "FAIL" : "PASS");
+
+	return errors ? 1 : 0;
+}
+
+
+//////////////////////////////////////////////
+//Test_ctor
+//The rate 1 period is the same rounding of
+//the same clock as rate 0 in bsp.c.
+static void Test_ctor(void)
+{
+	TestTick1Counts = SimTickCounts * BSP_TICKS_PER_SEC / BSP_TICKS1_PER_SEC;
+
+	Test_aoCtor(&AO_A, "a", TEST_A_PERIOD, TEST_A_FINE);
+	Test_aoCtor(&AO_B, "b", TEST_B_PERIOD, TEST_B_FINE);
+}
+
+
+static void Test_aoCtor(TestAO* me, const char* name, uint16_t period, uint16_t fine)
+{
+	QActive_ctor(&me->super, Q_STATE_CAST(&Test_initial));
+	me->name = name;
+	me->period = period;
+	me->fine = fine;
+}
+
+
+static QState Test_initial(TestAO* const me)
+{
+	return Q_TRAN(&Test_active);
+}
+
+
+static QState Test_active(TestAO* const me)
+{
+	QState status;
+	uint32_t due;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			QActive_armX((QActive *)me, 0U, me->period);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT_SIG:
+		{
+			//the last rate 1 timeouts are long over
+			if (((CCTL1 & CCIE) != 0U) && (AO_A.timeouts == AO_A.arms)
+				&& (AO_B.timeouts == AO_B.arms))
+			{
+				me->errors++;
+			}
+
+			me->armed = SimTime;
+			me->running = ((CCTL1 & CCIE) != 0U);
+			me->arms++;
+			QActive_armX((QActive *)me, 0U, me->period);
+			QActive_armX((QActive *)me, 1U, me->fine);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT1_SIG:
+		{
+			due = me->armed + me->fine * TestTick1Counts;
+
+			if ((SimTime > due) || (!me->running && (SimTime != due))
+				|| (SimTime + TestTick1Counts <= due))
+			{
+				me->errors++;
+			}
+
+			me->timeouts++;
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+//////////////////////////////////////////////
+//Test_print
+//Also counts an error if a timeout never
+//came, the last arm can still be waiting.
+static void Test_print(TestAO* me)
+{
+	if (me->timeouts + 1 < me->arms)
+		me->errors++;
+
+	printf("%-2s  %6u  %4u  %4lu  %8lu  %6lu\n", me->name, me->period, me->fine,
+			(unsigned long)me->arms, (unsigned long)me->timeouts, (unsigned long)me->errors);
+}
@@ -0,0 +1,285 @@
+/*
+ * test_stat.c
+ *
+ *  Queue statistics (QF_ACTIVE_STAT) through the real
+ *  QP-nano kernel, one build for each of QK-nano and
+ *  vanilla, and test_stat_off without the option.
+ *
+ *  Source, the higher priority, times out every
+ *  TEST_PERIOD ticks and takes turns, with Sink, the
+ *  lower priority, not getting to run until it's done:
+ *  - posts a burst of TEST_BURST events to Sink, then
+ *    TEST_FAILS posts with a margin bigger than Sink's
+ *    queue, which all fail, then resets Sink's stats
+ *    with the burst still in the queue
+ *  - checks Sink dispatched the burst, resets the stats
+ *    with the queue empty and posts TEST_SMALL events
+ *  - checks the high-water mark started over from 0
+ *  Each turn checks maxUsed, nFail and nDispatch of
+ *  Sink against the posts and dispatches counted here,
+ *  and Source's own dispatches of its timeouts.
+ *
+ *  test_stat_off only checks that QActive has nothing
+ *  after nUsed, the same size as before the option.
+ *
+ *  Prints PASS or FAIL, exits with 1 on a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include "sim.h"
+
+#define TEST_TICKS			10
+#define TEST_PERIOD			2
+#define TEST_BURST			3
+#define TEST_SMALL			2
+#define TEST_FAILS			300			//nFail stops at 255
+
+#ifdef QK_PREEMPTIVE
+#define TEST_KERNEL			"QK-nano"
+#else
+#define TEST_KERNEL			"vanilla"
+#endif
+
+enum
+{
+	TEST_DATA_SIG = Q_USER_SIG,
+};
+
+typedef struct
+{
+	QActive super;
+	uint8_t turn;
+	uint16_t timeouts;
+} TestSource;
+
+typedef struct
+{
+	QActive super;
+	uint16_t events;
+} TestSink;
+
+static TestSource AO_Source;
+static TestSink AO_Sink;
+
+static QEvt l_sinkQSto[6];
+static QEvt l_sourceQSto[2];
+
+QActiveCB const Q_ROM QF_active[] = {
+	{ (QActive *)0,				(QEvt *)0,		0U					},
+	{ (QActive *)&AO_Sink,		l_sinkQSto,		Q_DIM(l_sinkQSto)	},
+	{ (QActive *)&AO_Source,	l_sourceQSto,	Q_DIM(l_sourceQSto)	}
+};
+
+Q_ASSERT_COMPILE(QF_MAX_ACTIVE == Q_DIM(QF_active) - 1);
+
+static uint32_t TestErrors = 0;
+
+static void Test_expect(const char* what, uint32_t value, uint32_t expect);
+
+#ifdef QF_ACTIVE_STAT
+
+static void Test_ctor(void);
+static QState Test_sourceInitial(TestSource* const me);
+static QState Test_sourceActive(TestSource* const me);
+static QState Test_sinkInitial(TestSink* const me);
+static QState Test_sinkActive(TestSink* const me);
+static void Test_post(uint16_t count, uint_fast8_t margin);
+static void Test_check(const char* turn, uint8_t maxUsed, uint8_t nFail, uint16_t nDispatch);
+
+
+int main(void)
+{
+	QActiveStat stat;
+
+	printf("queue statistics, %s, %u ticks\n", TEST_KERNEL, TEST_TICKS);
+
+	Sim_Main(TEST_TICKS, Test_ctor);
+
+	Test_expect("turns", AO_Source.turn, 3);
+	Test_expect("Sink events", AO_Sink.events, TEST_BURST + TEST_SMALL);
+
+	QActive_getStat(&AO_Source.super, &stat);
+	Test_expect("Source nDispatch", stat.nDispatch, AO_Source.timeouts);
+	Test_expect("Source maxUsed", stat.maxUsed, 1);
+	Test_expect("Source nFail", stat.nFail, 0);
+
+	printf("%s\n", TestErrors ? "FAIL" : "PASS");
+
+	return TestErrors ? 1 : 0;
+}
+
+
+static void Test_ctor(void)
+{
+	QActive_ctor(&AO_Source.super, Q_STATE_CAST(&Test_sourceInitial));
+	QActive_ctor(&AO_Sink.super, Q_STATE_CAST(&Test_sinkInitial));
+}
+
+
+static QState Test_sourceInitial(TestSource* const me)
+{
+	return Q_TRAN(&Test_sourceActive);
+}
+
+
+static QState Test_sourceActive(TestSource* const me)
+{
+	QState status;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			QActive_armX((QActive *)me, 0U, TEST_PERIOD);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT_SIG:
+		{
+			me->timeouts++;
+
+			switch (me->turn++)
+			{
+				case 0:
+					//the queue is empty, the burst is the high-water
+					//mark, the fails stop at 255
+					Test_post(TEST_BURST, 1U);
+					Test_check("burst", TEST_BURST, 0, 0);
+					Test_post(TEST_FAILS, Q_DIM(l_sinkQSto));
+					Test_check("fails", TEST_BURST, 0xFF, 0);
+
+					//the burst is still waiting
+					QActive_resetStat(&AO_Sink.super);
+					Test_check("reset", TEST_BURST, 0, 0);
+					break;
+
+				case 1:
+					Test_check("dispatched", TEST_BURST, 0, TEST_BURST);
+
+					//empty now, so starts over from 0
+					QActive_resetStat(&AO_Sink.super);
+					Test_check("reset empty", 0, 0, 0);
+					Test_post(TEST_SMALL, 1U);
+					break;
+
+				case 2:
+					Test_check("small", TEST_SMALL, 0, TEST_SMALL);
+					break;
+
+				default:
+					break;
+			}
+
+			if (me->turn < 3)
+				QActive_armX((QActive *)me, 0U, TEST_PERIOD);
+
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+static QState Test_sinkInitial(TestSink* const me)
+{
+	return Q_TRAN(&Test_sinkActive);
+}
+
+
+static QState Test_sinkActive(TestSink* const me)
+{
+	QState status;
+
+	switch (Q_SIG(me))
+	{
+		case TEST_DATA_SIG:
+		{
+			me->events++;
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+//////////////////////////////////////////////
+//Test_post
+//count posts to Sink with margin, the ones
+//that don't fit fail.
+static void Test_post(uint16_t count, uint_fast8_t margin)
+{
+	uint16_t i;
+
+	for (i = 0 ; i < count ; i++)
+		QACTIVE_POST_X((QActive *)&AO_Sink, margin, TEST_DATA_SIG, 0U);
+}
+
+
+//////////////////////////////////////////////
+//Test_check
+//Sink's stats against what they should be.
+static void Test_check(const char* turn, uint8_t maxUsed, uint8_t nFail, uint16_t nDispatch)
+{
+	QActiveStat stat;
+
+	QActive_getStat(&AO_Sink.super, &stat);
+
+	printf("%-12s maxUsed %3u  nFail %3u  nDispatch %3u\n", turn,
+			stat.maxUsed, stat.nFail, stat.nDispatch);
+
+	Test_expect("Sink maxUsed", stat.maxUsed, maxUsed);
+	Test_expect("Sink nFail", stat.nFail, nFail);
+	Test_expect("Sink nDispatch", stat.nDispatch, nDispatch);
+}
+
+#else
+
+int main(void)
+{
+	size_t end = offsetof(QActive, nUsed) + sizeof(((QActive *)0)->nUsed);
+	size_t align = __alignof__(QActive);
+
+	printf("queue statistics off, sizeof(QActive) %u\n", (unsigned)sizeof(QActive));
+
+	//nothing after nUsed but the padding
+	Test_expect("sizeof(QActive)", sizeof(QActive), (end + align - 1) / align * align);
+
+	printf("%s\n", TestErrors ? "FAIL" : "PASS");
+
+	return TestErrors ? 1 : 0;
+}
+
+#endif /* QF_ACTIVE_STAT */
+
+
+static void Test_expect(const char* what, uint32_t value, uint32_t expect)
+{
+	if (value == expect)
+		return;
+
+	printf("  %s is %lu, expected %lu\n", what, (unsigned long)value, (unsigned long)expect);
+	TestErrors++;
+}
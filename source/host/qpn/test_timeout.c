@@ -0,0 +1,224 @@
+/*
+ * test_timeout.c
+ *
+ *  Rate 0 timeouts through the real bsp.c and QP-nano
+ *  kernel, one build for each of QK-nano and vanilla,
+ *  fixed tick and tickless.
+ *
+ *  Two active objects re-arm a rate 0 timeout each
+ *  time it comes: fast every TEST_FAST_PERIOD ticks at
+ *  the higher priority with no work, slow every
+ *  TEST_SLOW_PERIOD with TEST_SLOW_COST ticks of work.
+ *  A timeout has to be posted on the tick boundary
+ *  its arm asked for, the boundary after the one it was
+ *  armed in plus the period.  QK-nano dispatches it
+ *  right there.  Vanilla does too, unless slow is in
+ *  the middle of a dispatch, then it's when slow ends.
+ *  Anything else, earlier or later, is a failure.  At
+ *  the end no timeout can be overdue.  Tickless can't
+ *  wake the cpu more often than the timeouts come.
+ *
+ *  Time is simulated (sim.h), so the counts are the
+ *  same on every host.  Prints the timeouts, the timer
+ *  isrs and how many of them woke the cpu, and PASS or
+ *  FAIL.  Exits with 1 on a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "qpn_port.h"
+#include "bsp.h"
+#include "sim.h"
+
+#define TEST_TICKS			60
+#define TEST_FAST_PERIOD	7
+#define TEST_SLOW_PERIOD	10
+#define TEST_SLOW_COST		25			//tenths of a tick
+
+#ifdef QK_PREEMPTIVE
+#define TEST_KERNEL			"QK-nano"
+#else
+#define TEST_KERNEL			"vanilla"
+#endif
+
+typedef struct
+{
+	QActive super;
+	const char* name;
+	uint16_t period;			//ticks
+	uint32_t cost;				//counts
+	uint32_t armed;				//SimTime of the last arm
+	uint32_t timeouts;
+	uint32_t errors;
+	uint32_t maxLatency;		//counts from the post to the dispatch
+} TestAO;
+
+static TestAO AO_Slow;
+static TestAO AO_Fast;
+
+static QEvt l_slowQSto[2];
+static QEvt l_fastQSto[2];
+
+QActiveCB const Q_ROM QF_active[] = {
+	{ (QActive *)0,				(QEvt *)0,		0U					},
+	{ (QActive *)&AO_Slow,		l_slowQSto,		Q_DIM(l_slowQSto)	},
+	{ (QActive *)&AO_Fast,		l_fastQSto,		Q_DIM(l_fastQSto)	}
+};
+
+Q_ASSERT_COMPILE(QF_MAX_ACTIVE == Q_DIM(QF_active) - 1);
+
+static uint32_t TestSlowStart = 0;
+static uint32_t TestSlowEnd = 0;
+
+static void Test_ctor(void);
+static void Test_aoCtor(TestAO* me, const char* name, uint16_t period, uint32_t cost);
+static QState Test_initial(TestAO* const me);
+static QState Test_active(TestAO* const me);
+static uint32_t Test_due(TestAO* me);
+static void Test_print(TestAO* me);
+
+
+int main(void)
+{
+	uint32_t errors;
+
+	Sim_Main(TEST_TICKS, Test_ctor);
+
+	printf("rate 0 timeouts, %s, %s, %u ticks of %lu counts\n", TEST_KERNEL,
+			BSP_TICKLESS ? "tickless" : "fixed tick", TEST_TICKS, (unsigned long)SimTickCounts);
+	printf("ao    period  cost  timeouts  max latency  errors\n");
+
+	Test_print(&AO_Fast);
+	Test_print(&AO_Slow);
+
+	printf("timer isrs %lu, %lu of them woke the cpu, %lu torn TAR reads\n",
+			(unsigned long)SimIsrs, (unsigned long)SimWakes, (unsigned long)SimTornReads);
+
+	errors = AO_Fast.errors + AO_Slow.errors;
+
+	//tickless only wakes at the end of a period,
+	//and a period never goes past a timeout
+	if (BSP_TICKLESS && (SimWakes > AO_Fast.timeouts + AO_Slow.timeouts))
+	{
+		printf("more wakes than timeouts\n");
+		errors++;
+	}
+
+	printf("%s\n", errors ? "FAIL" : "PASS");
+
+	return errors ? 1 : 0;
+}
+
+
+static void Test_ctor(void)
+{
+	Test_aoCtor(&AO_Slow, "slow", TEST_SLOW_PERIOD, TEST_SLOW_COST);
+	Test_aoCtor(&AO_Fast, "fast", TEST_FAST_PERIOD, 0);
+}
+
+
+//////////////////////////////////////////////
+//Test_aoCtor
+//cost is in tenths of a tick, SimTickCounts
+//is known by the time this runs.
+static void Test_aoCtor(TestAO* me, const char* name, uint16_t period, uint32_t cost)
+{
+	QActive_ctor(&me->super, Q_STATE_CAST(&Test_initial));
+	me->name = name;
+	me->period = period;
+	me->cost = cost * SimTickCounts / 10;
+}
+
+
+static QState Test_initial(TestAO* const me)
+{
+	return Q_TRAN(&Test_active);
+}
+
+
+static QState Test_active(TestAO* const me)
+{
+	QState status;
+	uint32_t due;
+
+	switch (Q_SIG(me))
+	{
+		case Q_ENTRY_SIG:
+		{
+			me->armed = SimTime;
+			QActive_armX((QActive *)me, 0U, me->period);
+			status = Q_HANDLED();
+			break;
+		}
+
+		case Q_TIMEOUT_SIG:
+		{
+			due = Test_due(me);
+
+#ifndef QK_PREEMPTIVE
+			//vanilla doesn't preempt slow
+			if ((me == &AO_Fast) && (due > TestSlowStart) && (due < TestSlowEnd))
+				due = TestSlowEnd;
+#endif
+
+			if (SimTime != due)
+				me->errors++;
+
+			if ((SimTime >= Test_due(me)) && (SimTime - Test_due(me) > me->maxLatency))
+				me->maxLatency = SimTime - Test_due(me);
+
+			me->timeouts++;
+			me->armed = SimTime;
+			QActive_armX((QActive *)me, 0U, me->period);
+
+			if (me->cost)
+			{
+				TestSlowStart = SimTime;
+				TestSlowEnd = SimTime + me->cost;
+				Sim_Busy(me->cost);
+			}
+
+			status = Q_HANDLED();
+			break;
+		}
+
+		default:
+		{
+			status = Q_SUPER(&QHsm_top);
+			break;
+		}
+	}
+
+	return status;
+}
+
+
+//////////////////////////////////////////////
+//Test_due
+//SimTime the timeout armed last should be
+//posted at.
+static uint32_t Test_due(TestAO* me)
+{
+	return (me->armed / SimTickCounts + me->period) * SimTickCounts;
+}
+
+
+//////////////////////////////////////////////
+//Test_print
+//Also counts an error if a timeout is overdue
+//at the end.
+static void Test_print(TestAO* me)
+{
+	uint32_t end = TEST_TICKS * SimTickCounts;
+	uint32_t slack = (me == &AO_Fast) ? AO_Slow.cost : 0;
+
+	if (Test_due(me) + slack < end)
+		me->errors++;
+
+	printf("%-4s  %6u  %4.1f  %8lu  %7.2f tick  %6lu\n", me->name, me->period,
+			(double)me->cost / SimTickCounts, (unsigned long)me->timeouts,
+			(double)me->maxLatency / SimTickCounts, (unsigned long)me->errors);
+}
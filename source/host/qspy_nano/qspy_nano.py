@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+#
+# qspy_nano.py
+#
+# Host side of the QS-nano trace in msp430_qpn_Blink1
+# (qpn/qsn.h).  Reads the frames from the serial port or
+# a file, prints the timeline and the per AO statistics.
+# See README.md.
+#
+
+import argparse
+import sys
+
+FRAME = 0x7E
+ESC = 0x7D
+ESC_XOR = 0x20
+REC_SIZE = 8
+
+# record types, keep in sync with enum QSpyRecords in qsn.h
+QS_QF_POST = 1
+QS_QF_POST_ISR = 2
+QS_QF_POST_FAIL = 3
+QS_QF_TICK = 4
+QS_QF_DISPATCH = 5
+QS_QF_DONE = 6
+QS_QEP_TRAN = 7
+
+REC_NAMES = {
+    QS_QF_POST: "POST",
+    QS_QF_POST_ISR: "POST_ISR",
+    QS_QF_POST_FAIL: "POST_FAIL",
+    QS_QF_TICK: "TICK",
+    QS_QF_DISPATCH: "DISPATCH",
+    QS_QF_DONE: "DONE",
+    QS_QEP_TRAN: "TRAN",
+}
+
+# reserved signals from qepn.h
+SIG_NAMES = {
+    1: "Q_ENTRY",
+    2: "Q_EXIT",
+    3: "Q_INIT",
+    4: "Q_TIMEOUT",
+    5: "Q_TIMEOUT1",
+    6: "Q_TIMEOUT2",
+    7: "Q_TIMEOUT3",
+}
+
+
+###########################################
+# Frames
+# Split the stream on the flag, undo the escapes
+# and check the sum.  Yields (record bytes) or None
+# for a bad frame.
+def frames(chunks):
+    frame = bytearray()
+    esc = False
+    for chunk in chunks:
+        for b in chunk:
+            if b == FRAME:
+                if len(frame) == REC_SIZE + 1 and (sum(frame) & 0xFF) == 0xFF:
+                    yield bytes(frame[:REC_SIZE])
+                elif frame:
+                    yield None
+                frame = bytearray()
+                esc = False
+            elif b == ESC:
+                esc = True
+            else:
+                if esc:
+                    b ^= ESC_XOR
+                    esc = False
+                frame.append(b)
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def read_port(port, baud):
+    import serial  # pyserial, only needed for a live port
+    with serial.Serial(port, baud, timeout=0.5) as ser:
+        while True:
+            yield ser.read(256)
+
+
+class Stats:
+    def __init__(self):
+        self.n = 0
+        self.total = 0
+        self.min = None
+        self.max = 0
+
+    def add(self, value):
+        self.n += 1
+        self.total += value
+        self.min = value if self.min is None else min(self.min, value)
+        self.max = max(self.max, value)
+
+    def __str__(self):
+        if self.n == 0:
+            return "-"
+        return "%8.3f %8.3f %8.3f" % (self.min, self.total / self.n, self.max)
+
+
+class AO:
+    def __init__(self):
+        self.posts = []            # post times not dispatched yet, FIFO
+        self.latency = Stats()     # post to dispatch, ms
+        self.run = Stats()         # dispatch to done, less preemption, ms
+        self.depth = 0             # deepest queue seen
+        self.events = 0
+        self.trans = 0
+        self.fails = 0
+
+
+#############################################
+# Decoder
+# Unwraps the 16 bit timestamps, matches posts to
+# dispatches per AO (the queues are FIFO) and keeps
+# a stack of dispatches for QK-nano preemption.
+class Decoder:
+    def __init__(self, clock, ao_names, sig_names, quiet):
+        self.clock = clock
+        self.ao_names = ao_names
+        self.sig_names = sig_names
+        self.quiet = quiet
+        self.aos = {}
+        self.stack = []            # [prio, start, preempted]
+        self.time = None
+        self.last_ts = 0
+        self.seq = None
+        self.lost = 0
+        self.bad = 0
+        self.ticks = 0
+
+    def ao(self, prio):
+        return self.aos.setdefault(prio, AO())
+
+    def ao_name(self, prio):
+        return self.ao_names.get(prio, "ao%d" % prio)
+
+    def sig_name(self, sig):
+        return self.sig_names.get(sig, SIG_NAMES.get(sig, "sig%d" % sig))
+
+    def ms(self, counts):
+        return counts * 1000.0 / self.clock
+
+    def lose(self, n):
+        # can't tell what the missing records were, start
+        # the matching over
+        self.lost += n
+        for ao in self.aos.values():
+            ao.posts = []
+        self.stack = []
+
+    def record(self, rec):
+        if rec is None:
+            self.bad += 1
+            self.lose(0)
+            return
+
+        seq, kind, prio, sig = rec[0], rec[1], rec[2], rec[3]
+        data = rec[4] | (rec[5] << 8)
+        ts = rec[6] | (rec[7] << 8)
+
+        if self.seq is not None and seq != ((self.seq + 1) & 0xFF):
+            self.lose((seq - self.seq - 1) & 0xFF)
+        self.seq = seq
+
+        if self.time is None:
+            self.time = 0
+        else:
+            self.time += (ts - self.last_ts) & 0xFFFF
+        self.last_ts = ts
+        now = self.time
+
+        if kind in (QS_QF_POST, QS_QF_POST_ISR):
+            ao = self.ao(prio)
+            ao.posts.append(now)
+            ao.depth = max(ao.depth, data)
+            text = "%-10s %-10s depth %d" % (self.ao_name(prio), self.sig_name(sig), data)
+        elif kind == QS_QF_POST_FAIL:
+            self.ao(prio).fails += 1
+            text = "%-10s %-10s depth %d" % (self.ao_name(prio), self.sig_name(sig), data)
+        elif kind == QS_QF_TICK:
+            self.ticks += 1
+            text = "rate %d" % data
+        elif kind == QS_QF_DISPATCH:
+            ao = self.ao(prio)
+            ao.events += 1
+            if ao.posts:
+                ao.latency.add(self.ms(now - ao.posts.pop(0)))
+            self.stack.append([prio, now, 0])
+            text = "%-10s %-10s left %d" % (self.ao_name(prio), self.sig_name(sig), data)
+        elif kind == QS_QF_DONE:
+            text = self.ao_name(prio)
+            if self.stack and self.stack[-1][0] == prio:
+                _, start, preempted = self.stack.pop()
+                self.ao(prio).run.add(self.ms(now - start - preempted))
+                if self.stack:
+                    self.stack[-1][2] += now - start
+                text += " %.3f ms" % self.ms(now - start - preempted)
+        elif kind == QS_QEP_TRAN:
+            name = "?"
+            if self.stack:
+                name = self.ao_name(self.stack[-1][0])
+                self.ao(self.stack[-1][0]).trans += 1
+            text = "%-10s %-10s to 0x%04X" % (name, self.sig_name(sig), data)
+        else:
+            text = "unknown record %d" % kind
+
+        if not self.quiet:
+            print("%12.3f ms  %-9s %s" % (self.ms(now), REC_NAMES.get(kind, "?"), text))
+
+    def report(self):
+        print()
+        print("records lost %d, bad frames %d, ticks %d" % (self.lost, self.bad, self.ticks))
+        print("%-10s %6s %6s %5s %5s  %-26s  %-26s" % ("ao", "events", "trans", "depth", "fails",
+                                                       "latency min/avg/max ms", "run min/avg/max ms"))
+        for prio in sorted(self.aos):
+            ao = self.aos[prio]
+            print("%-10s %6d %6d %5d %5d  %-26s  %-26s" % (self.ao_name(prio), ao.events, ao.trans,
+                                                           ao.depth, ao.fails, ao.latency, ao.run))
+
+
+def names(pairs):
+    table = {}
+    for pair in pairs or []:
+        number, name = pair.split("=", 1)
+        table[int(number, 0)] = name
+    return table
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the QS-nano trace from msp430_qpn_Blink1")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port, e.g. /dev/ttyACM0 (needs pyserial)")
+    source.add_argument("--file", help="file with the raw bytes from the uart")
+    parser.add_argument("--baud", type=int, default=9600)
+    parser.add_argument("--clock", type=float, default=1000000.0,
+                        help="Hz of the timestamp timer, 1000000 for the fixed tick (default), "
+                             "12000 tickless (VLO)")
+    parser.add_argument("--ao", action="append", metavar="PRIO=NAME",
+                        help="name an AO by priority, e.g. --ao 1=Button")
+    parser.add_argument("--sig", action="append", metavar="SIG=NAME",
+                        help="name a signal, e.g. --sig 8=BUTTON_PRESS")
+    parser.add_argument("--quiet", action="store_true", help="statistics only, no timeline")
+    args = parser.parse_args()
+
+    decoder = Decoder(args.clock, names(args.ao), names(args.sig), args.quiet)
+    chunks = read_port(args.port, args.baud) if args.port else read_file(args.file)
+    try:
+        for rec in frames(chunks):
+            decoder.record(rec)
+    except KeyboardInterrupt:
+        pass
+    decoder.report()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,239 @@
+/*
+ * SimpleOS_posix.c
+ *
+ *  SimpleOS port for a POSIX host, see SimpleOS_posix.h.
+ *  Same scheduler and Task.c as the msp430, only the
+ *  switch is different.  SimpleOS_ISR runs in the SIGALRM
+ *  handler, SimpleOS_switchISR in the SIGUSR1 handler, and
+ *  they swap ucontexts instead of stacks, so a thread
+ *  that isn't running is stopped in a handler, the same
+ *  as one stopped in the timer isr.
+ *
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#include <sys/time.h>
+
+#include "SimpleOS.h"
+#include "Task.h"
+
+extern TaskStruct* RunPt;
+extern TaskStruct* NextPt;
+extern volatile uint8_t gTickPending;
+
+//////////////////////////////////////////
+//A context per task block, the thread
+//function it starts in and where it goes
+//if the function returns
+static ucontext_t PortContext[MAXTHREADS];
+static void (*PortFunction[MAXTHREADS])(void);
+static void (*PortExit)(void) = NULL;
+
+static sigset_t gStatusMask;                    //enter/exit critical
+
+
+static void SimpleOS_portEntry(void);
+static void SimpleOS_portSignal(int signal);
+static void SimpleOS_portMaskSet(sigset_t* set);
+
+
+
+/////////////////////////////////////////////////////
+//Start the tick and switch to RunPt.  Both signals
+//are blocked since SimpleOS_init(), a tick or switch
+//that comes before the first thread waits for it.
+void SimpleOS_start(void)
+{
+    struct sigaction action;
+    struct itimerval timer;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SimpleOS_portSignal;
+    SimpleOS_portMaskSet(&action.sa_mask);      //both blocked in either handler
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+    sigaction(SIGUSR1, &action, NULL);
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = SIMPLEOS_TICK_US;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    setcontext(&PortContext[RunPt->index]);
+}
+
+
+//////////////////////////////////////////////////
+//SimpleOS_EnterCritical.
+//Save the signal mask and block the tick and switch.
+void SimpleOS_EnterCritical(void)
+{
+    sigset_t set;
+
+    SimpleOS_portMaskSet(&set);
+    sigprocmask(SIG_BLOCK, &set, &gStatusMask);
+}
+
+
+//////////////////////////////////////////////////
+//SimpleOS_ExitCritical.
+//Put the signal mask back.
+void SimpleOS_ExitCritical(void)
+{
+    sigprocmask(SIG_SETMASK, &gStatusMask, NULL);
+}
+
+
+//////////////////////////////////////////////////////////
+//SimpleOS_ISR
+//The tick, called in the SIGALRM handler.  Sets
+//gTickPending and does the rest in SimpleOS_switchISR.
+void SimpleOS_ISR(void)
+{
+    gTickPending = 1;
+    SimpleOS_switchISR();
+}
+
+
+//////////////////////////////////////////////////////////
+//SimpleOS_switchISR
+//Called in the SIGUSR1 handler, or from the tick, with
+//both signals blocked.  Run the scheduler, if NextPt is
+//a different thread save the context of RunPt and
+//switch to NextPt.  The swap comes back here when RunPt
+//is picked again, and the handler returns to the thread.
+void SimpleOS_switchISR(void)
+{
+    TaskStruct* task = RunPt;
+
+    SimpleOS_scheduler();
+
+    if (NextPt != task)
+    {
+        RunPt = NextPt;
+        swapcontext(&PortContext[task->index], &PortContext[RunPt->index]);
+    }
+}
+
+
+/////////////////////////////////////////////////////////
+//Task_initFrame
+//Make a context on the task stack that starts in
+//SimpleOS_portEntry() with the tick unblocked.  The
+//stack is already painted by Task_initStack().  sp
+//isn't used for the switch, it's set to the top so
+//Task_checkStack() only looks at the canary.
+void Task_initFrame(TaskStruct* task, void (*functionPtr)(void), void (*exitPtr)(void))
+{
+    ucontext_t* context = &PortContext[task->index];
+
+    PortFunction[task->index] = functionPtr;
+    PortExit = exitPtr;
+
+    getcontext(context);
+    context->uc_stack.ss_sp = task->stack;
+    context->uc_stack.ss_size = task->stackSize * sizeof(int16_t);
+    context->uc_link = NULL;
+    sigemptyset(&context->uc_sigmask);          //GIE set
+    makecontext(context, SimpleOS_portEntry, 0);
+
+    task->sp = &task->stack[task->stackSize - 1];
+}
+
+
+//////////////////////////////////////////////
+//Port functions for SimpleOS_posix.h
+void SimpleOS_portDisable(void)
+{
+    sigset_t set;
+
+    SimpleOS_portMaskSet(&set);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+}
+
+
+void SimpleOS_portEnable(void)
+{
+    sigset_t set;
+
+    SimpleOS_portMaskSet(&set);
+    sigprocmask(SIG_UNBLOCK, &set, NULL);
+}
+
+
+//////////////////////////////////////////////
+//Take a pending SIGUSR1 off without running the
+//handler, returns right away if there isn't one.
+//Only called with it blocked.
+void SimpleOS_portClearSwitch(void)
+{
+    static const struct timespec now = {0, 0};
+    sigset_t set;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+
+    sigtimedwait(&set, NULL, &now);
+}
+
+
+//////////////////////////////////////////////
+//Unblock the tick and switch and sleep until a
+//handler has run, they're blocked again on the way
+//out.  Same as the LPM0 idle on the msp430.
+void SimpleOS_portIdle(void)
+{
+    sigset_t set;
+
+    sigprocmask(SIG_BLOCK, NULL, &set);
+    sigdelset(&set, SIGALRM);
+    sigdelset(&set, SIGUSR1);
+    sigsuspend(&set);
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_portEntry
+//First thing a new thread runs.  RunPt is the
+//new thread, call it's function, go to the exit
+//function if it returns.
+static void SimpleOS_portEntry(void)
+{
+    PortFunction[RunPt->index]();
+    PortExit();
+}
+
+
+//////////////////////////////////////////////
+//SimpleOS_portSignal
+//SIGALRM and SIGUSR1 handler.  errno belongs to
+//the thread that got interrupted, keep it for when
+//it runs again.
+static void SimpleOS_portSignal(int signal)
+{
+    int error = errno;
+
+    if (signal == SIGALRM)
+        SimpleOS_ISR();
+    else
+        SimpleOS_switchISR();
+
+    errno = error;
+}
+
+
+static void SimpleOS_portMaskSet(sigset_t* set)
+{
+    sigemptyset(set);
+    sigaddset(set, SIGALRM);
+    sigaddset(set, SIGUSR1);
+}
@@ -0,0 +1,54 @@
+/*
+ * SimpleOS_posix.h
+ *
+ *  SimpleOS port for a POSIX host, see SimpleOS_port.h.
+ *  Threads are ucontexts on the stacks passed in.  The
+ *  tick is SIGALRM from an interval timer.  A switch
+ *  between ticks raises SIGUSR1 while it's blocked, like
+ *  setting the CCR1 flag.  Blocking both is the same as
+ *  clearing GIE.  Build with SIMPLEOS_PORT_POSIX defined,
+ *  see README.md.
+ *
+ */
+
+#ifndef SIMPLEOS_SIMPLEOS_POSIX_H_
+#define SIMPLEOS_SIMPLEOS_POSIX_H_
+
+#include <signal.h>
+
+
+////////////////////////////////////
+//Tick in us, less than a second
+#ifndef SIMPLEOS_TICK_US
+#define SIMPLEOS_TICK_US            1000
+#endif
+
+////////////////////////////////////
+//Stacks in words.  The C library and the
+//signal frame need a lot more than the msp430.
+#define STACK_SIZE                  8192
+#define STACK_MIN                   4096
+
+////////////////////////////////////
+//Profiling is msp430 only
+#undef SIMPLEOS_PROFILE
+#define SIMPLEOS_PROFILE            0
+
+
+////////////////////////////////////
+//Port
+void SimpleOS_portDisable(void);
+void SimpleOS_portEnable(void);
+void SimpleOS_portClearSwitch(void);
+void SimpleOS_portIdle(void);
+
+#define SIMPLEOS_DISABLE()          SimpleOS_portDisable()
+#define SIMPLEOS_ENABLE()           SimpleOS_portEnable()
+#define SIMPLEOS_SWITCH_INIT()                  //SimpleOS_start() does it
+#define SIMPLEOS_PEND_SWITCH()      raise(SIGUSR1)
+#define SIMPLEOS_CLEAR_SWITCH()     SimpleOS_portClearSwitch()
+#define SIMPLEOS_IDLE()             SimpleOS_portIdle()
+
+
+
+#endif /* SIMPLEOS_SIMPLEOS_POSIX_H_ */
@@ -0,0 +1,49 @@
+/*
+ * bench.c
+ *
+ *  See bench.h.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "SimpleOS.h"
+#include "bench.h"
+
+
+//////////////////////////////////////////////
+//Bench_now
+//Monotonic host time in ns.
+uint64_t Bench_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+
+//////////////////////////////////////////////
+//Bench_print
+//printf with the tick blocked, so another
+//thread can't get switched in while stdio is
+//locked.  Call from a thread after launch.
+void Bench_print(const char* format, ...)
+{
+    va_list args;
+
+    SimpleOS_EnterCritical();
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    fflush(stdout);
+
+    SimpleOS_ExitCritical();
+}
@@ -0,0 +1,20 @@
+/*
+ * bench.h
+ *
+ *  Shared by the tests and benchmarks in this folder.
+ *  A host clock and a print that can't be switched out
+ *  half way.
+ *
+ */
+
+#ifndef SIMPLEOS_POSIX_BENCH_H_
+#define SIMPLEOS_POSIX_BENCH_H_
+
+#include <stdint.h>
+
+extern volatile uint32_t gTimerTick;            //SimpleOS.c
+
+uint64_t Bench_now(void);                       //host clock in ns
+void Bench_print(const char* format, ...);      //printf in a critical section
+
+#endif /* SIMPLEOS_POSIX_BENCH_H_ */
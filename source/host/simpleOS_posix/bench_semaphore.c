@@ -0,0 +1,161 @@
+/*
+ * bench_semaphore.c
+ *
+ *  Semaphore latency of SimpleOS on the POSIX port, from
+ *  SimpleOS_semaphoreSignal() to the waiting thread
+ *  running.
+ *
+ *  higher - the waiter has a higher priority than the
+ *           signaller, the signal switches to it.
+ *  same   - same priority, the waiter runs when the
+ *           signaller yields right after the signal.
+ *  busy   - same, but the signaller doesn't yield.  The
+ *           waiter waits for the tick to end the
+ *           signaller's timeslice, up to one tick.
+ *
+ *  The signaller stamps the time just before the signal,
+ *  the waiter takes the difference as soon as it's back
+ *  from the wait.  Each case takes BENCH_SAMPLES and
+ *  prints the median, the fastest and the slowest in ns.
+ *  busy runs fewer, each one takes up to a tick.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
+#include "bench.h"
+
+#define BENCH_SAMPLES       20000
+#define BENCH_SAMPLES_BUSY  500
+
+enum
+{
+    BENCH_HIGHER,
+    BENCH_SAME,
+    BENCH_BUSY,
+};
+
+static void Bench_main(void);
+static void Bench_waiter(void);
+static void Bench_signaller(void);
+static void Bench_run(const char* name, uint8_t mode, uint32_t samples);
+static int Bench_compare(const void* a, const void* b);
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stackWaiter[STACK_SIZE];
+static int16_t stackSignaller[STACK_SIZE];
+
+static int16_t gSignal = 0;
+static uint8_t gMode = BENCH_HIGHER;
+static uint32_t gSamples = 0;
+static volatile uint32_t gCount = 0;
+static volatile uint64_t gStamp = 0;
+static volatile uint8_t gTaken = 1;             //waiter has the last stamp
+static uint32_t gLatency[BENCH_SAMPLES];
+
+
+int main(void)
+{
+    if (SimpleOS_init(Bench_main, 0, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+static void Bench_main(void)
+{
+    Bench_print("semaphore signal to waiter running, ns\n");
+    Bench_print("case      samples    median       min       max\n");
+
+    Bench_run("higher", BENCH_HIGHER, BENCH_SAMPLES);
+    Bench_run("same", BENCH_SAME, BENCH_SAMPLES);
+    Bench_run("busy", BENCH_BUSY, BENCH_SAMPLES_BUSY);
+
+    exit(0);
+}
+
+
+//////////////////////////////////////////////
+//Bench_run
+//Add the two threads, wait for them to finish
+//and print the results.
+static void Bench_run(const char* name, uint8_t mode, uint32_t samples)
+{
+    int waiter, signaller;
+
+    gSignal = 0;
+    gMode = mode;
+    gSamples = samples;
+    gCount = 0;
+    gTaken = 1;
+
+    waiter = SimpleOS_addThread(Bench_waiter, (mode == BENCH_HIGHER) ? 1 : 2, stackWaiter, STACK_SIZE);
+    signaller = SimpleOS_addThread(Bench_signaller, 2, stackSignaller, STACK_SIZE);
+
+    SimpleOS_join(waiter);
+    SimpleOS_join(signaller);
+
+    qsort(gLatency, samples, sizeof(gLatency[0]), Bench_compare);
+
+    Bench_print("%-6s    %7lu  %8lu  %8lu  %8lu\n", name, (unsigned long)samples,
+            (unsigned long)gLatency[samples / 2], (unsigned long)gLatency[0],
+            (unsigned long)gLatency[samples - 1]);
+}
+
+
+//////////////////////////////////////////////
+//Bench_waiter
+static void Bench_waiter(void)
+{
+    while (gCount < gSamples)
+    {
+        SimpleOS_semaphoreWait(&gSignal);
+
+        gLatency[gCount] = (uint32_t)(Bench_now() - gStamp);
+        gCount++;
+        gTaken = 1;
+    }
+}
+
+
+//////////////////////////////////////////////
+//Bench_signaller
+//Signal once the waiter has taken the last
+//one.  In busy it spins until then instead of
+//yielding.
+static void Bench_signaller(void)
+{
+    while (gCount < gSamples)
+    {
+        if (!gTaken)
+        {
+            if (gMode == BENCH_SAME)
+                SimpleOS_yield();
+
+            continue;
+        }
+
+        gTaken = 0;
+        gStamp = Bench_now();
+        SimpleOS_semaphoreSignal(&gSignal);
+
+        if (gMode == BENCH_SAME)
+            SimpleOS_yield();
+    }
+}
+
+
+static int Bench_compare(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
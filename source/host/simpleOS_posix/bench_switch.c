@@ -0,0 +1,157 @@
+/*
+ * bench_switch.c
+ *
+ *  Context switch cost of SimpleOS on the POSIX port.
+ *
+ *  Two threads pass a semaphore back and forth.  The low
+ *  priority one signals, the high priority one is waiting
+ *  on it so the signal switches to it right away, it
+ *  counts and waits again, which switches back.  Two
+ *  switches a round.  The same signal and wait in one
+ *  thread, where the wait never blocks, is the cost of
+ *  the calls without the switches.  The difference over
+ *  two is one switch: pending SIGUSR1, the handler, the
+ *  scheduler and swapcontext.
+ *
+ *  The main thread has the highest priority and times
+ *  each case with SimpleOS_delay(), then stops and joins
+ *  the threads and starts the next case.  Times are host
+ *  ns, signals and sigprocmask() make them much longer
+ *  than the msp430 switch.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
+#include "bench.h"
+
+#define BENCH_TICKS         1000        //per case, 1s with the default tick
+
+static void Bench_main(void);
+static void Bench_high(void);
+static void Bench_low(void);
+static void Bench_alone(void);
+static double Bench_run(void (*first)(void), void (*second)(void));
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stackHigh[STACK_SIZE];
+static int16_t stackLow[STACK_SIZE];
+
+static int16_t gSignal = 0;
+static volatile uint32_t gRounds = 0;
+static volatile uint8_t gStop = 0;
+
+
+int main(void)
+{
+    if (SimpleOS_init(Bench_main, 0, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+//////////////////////////////////////////////
+//Bench_main
+//Run both cases, print and exit.
+static void Bench_main(void)
+{
+    double alone;
+    double pingPong;
+
+    alone = Bench_run(Bench_alone, NULL);
+    pingPong = Bench_run(Bench_high, Bench_low);
+
+    Bench_print("context switch, ns, %u ticks a case\n", BENCH_TICKS);
+    Bench_print("signal + wait, no switch      %8.1f\n", alone);
+    Bench_print("signal + wait, two switches   %8.1f\n", pingPong);
+    Bench_print("one switch                    %8.1f\n", (pingPong - alone) / 2);
+
+    exit(0);
+}
+
+
+//////////////////////////////////////////////
+//Bench_run
+//Add the threads, let them run for BENCH_TICKS,
+//stop them.  Returns ns per round.
+static double Bench_run(void (*first)(void), void (*second)(void))
+{
+    int threadFirst, threadSecond = -1;
+    uint32_t rounds;
+    uint64_t start;
+
+    gSignal = 0;
+    gRounds = 0;
+    gStop = 0;
+
+    threadFirst = SimpleOS_addThread(first, 1, stackHigh, STACK_SIZE);
+
+    if (second != NULL)
+        threadSecond = SimpleOS_addThread(second, 2, stackLow, STACK_SIZE);
+
+    start = Bench_now();
+    SimpleOS_delay(BENCH_TICKS);
+
+    rounds = gRounds;
+    start = Bench_now() - start;
+
+    gStop = 1;
+
+    if (threadSecond >= 0)
+        SimpleOS_join(threadSecond);
+
+    SimpleOS_join(threadFirst);
+
+    return rounds ? (double)start / rounds : 0.0;
+}
+
+
+//////////////////////////////////////////////
+//Bench_high
+//Waits for Bench_low, counts a round.
+static void Bench_high(void)
+{
+    while (1)
+    {
+        SimpleOS_semaphoreWait(&gSignal);
+
+        if (gStop)
+            return;
+
+        gRounds++;
+    }
+}
+
+
+//////////////////////////////////////////////
+//Bench_low
+//Signals Bench_high, one more time at the end
+//so it sees the stop.
+static void Bench_low(void)
+{
+    while (!gStop)
+        SimpleOS_semaphoreSignal(&gSignal);
+
+    SimpleOS_semaphoreSignal(&gSignal);
+}
+
+
+//////////////////////////////////////////////
+//Bench_alone
+//The same calls with no one to switch to.
+static void Bench_alone(void)
+{
+    while (!gStop)
+    {
+        SimpleOS_semaphoreSignal(&gSignal);
+        SimpleOS_semaphoreWait(&gSignal);
+        gRounds++;
+    }
+}
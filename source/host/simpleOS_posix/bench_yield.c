@@ -0,0 +1,122 @@
+/*
+ * bench_yield.c
+ *
+ *  SimpleOS_yield() throughput on the POSIX port, yields
+ *  per second with 1 to 3 threads at the same priority
+ *  that do nothing but yield.  With one thread the yield
+ *  comes back to it, no switch.
+ *
+ *  The yields pend a switch all the time, so this also
+ *  checks that none of the ticks are lost to them.  The
+ *  main thread sleeps BENCH_TICKS with SimpleOS_delay()
+ *  and the host clock has to agree, within a few ticks
+ *  for the ones the host delivers late.  Exits with 1
+ *  if it's more than BENCH_TICK_SLACK percent out.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
+#include "bench.h"
+
+#define BENCH_TICKS         1000        //per case, 1s with the default tick
+#define BENCH_THREADS       3
+#define BENCH_TICK_SLACK    5           //percent
+
+static void Bench_main(void);
+static void Bench_yield(void);
+static int Bench_run(uint8_t threads);
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stacks[BENCH_THREADS][STACK_SIZE];
+
+static volatile uint32_t gYields = 0;
+static volatile uint8_t gStop = 0;
+
+
+int main(void)
+{
+    if (SimpleOS_init(Bench_main, 0, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+static void Bench_main(void)
+{
+    int errors = 0;
+    uint8_t threads;
+
+    Bench_print("yield throughput, %u ticks of %u us a case\n", BENCH_TICKS, SIMPLEOS_TICK_US);
+    Bench_print("threads   yields/s   ns/yield   ticks     ms\n");
+
+    for (threads = 1 ; threads <= BENCH_THREADS ; threads++)
+        errors += Bench_run(threads);
+
+    exit(errors ? 1 : 0);
+}
+
+
+//////////////////////////////////////////////
+//Bench_run
+//Yield with threads threads for BENCH_TICKS.
+//Returns 1 if the ticks and the host clock
+//don't agree.
+static int Bench_run(uint8_t threads)
+{
+    int thread[BENCH_THREADS];
+    uint32_t yields;
+    uint32_t ticks;
+    uint64_t ns;
+    uint8_t i;
+
+    gYields = 0;
+    gStop = 0;
+
+    for (i = 0 ; i < threads ; i++)
+        thread[i] = SimpleOS_addThread(Bench_yield, 1, stacks[i], STACK_SIZE);
+
+    ticks = gTimerTick;
+    ns = Bench_now();
+
+    SimpleOS_delay(BENCH_TICKS);
+
+    yields = gYields;
+    ns = Bench_now() - ns;
+    ticks = gTimerTick - ticks;
+
+    gStop = 1;
+
+    for (i = 0 ; i < threads ; i++)
+        SimpleOS_join(thread[i]);
+
+    Bench_print("%7u   %8.0f   %8.1f   %5lu  %5lu", threads, yields * 1e9 / ns,
+            yields ? (double)ns / yields : 0.0, (unsigned long)ticks, (unsigned long)(ns / 1000000));
+
+    //ticks as long as the host says they took
+    if ((uint64_t)ticks * SIMPLEOS_TICK_US * (100 + BENCH_TICK_SLACK) < ns / 1000 * 100)
+    {
+        Bench_print("  ticks lost\n");
+        return 1;
+    }
+
+    Bench_print("\n");
+    return 0;
+}
+
+
+static void Bench_yield(void)
+{
+    while (!gStop)
+    {
+        gYields++;
+        SimpleOS_yield();
+    }
+}
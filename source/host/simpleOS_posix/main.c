@@ -0,0 +1,130 @@
+/*
+ * SimpleOS on a POSIX host
+ *
+ * Same threads as the msp430_simpleOS project, with
+ * counters in place of the leds.  Task 1 prints the
+ * counters and the stack each thread has used after
+ * 10 rounds and ends the program.  See README.md to
+ * build it.
+ *
+ */
+//includes
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
+
+
+//prototypes
+void TaskFunction1(void);
+void TaskFunction2(void);
+void TaskFunction3(void);
+void TaskFunction4(void);
+
+
+
+///////////////////////////////////////////////
+//Task Counters
+volatile uint32_t counter1 = 0x00;
+volatile uint32_t counter2 = 0x00;
+volatile uint32_t counter3 = 0x00;
+volatile uint32_t counter4 = 0x00;
+
+////////////////////////////////////////////////
+//flags - semaphore counts
+int16_t task2Flag = 0;
+
+////////////////////////////////////////////////
+//Thread stacks
+int16_t stack1[STACK_SIZE];
+int16_t stack2[STACK_SIZE];
+int16_t stack3[STACK_SIZE];
+int16_t stack4[STACK_SIZE];
+
+
+//main program
+int main(void)
+{
+    //same priorities as the msp430 project
+    if (SimpleOS_init(TaskFunction1, 1, stack1, STACK_SIZE) < 0)
+    {
+        printf("stack too small\n");
+        return 1;
+    }
+
+    SimpleOS_addThread(TaskFunction2, 0, stack2, STACK_SIZE);
+    SimpleOS_addThread(TaskFunction3, 2, stack3, STACK_SIZE);
+    SimpleOS_addThread(TaskFunction4, 2, stack4, STACK_SIZE);
+
+    SimpleOS_launch();
+
+    //Should never make it here
+    return 1;
+}
+
+
+///////////////////////////////////////////
+//TaskFunction1
+//Signal task 2 every 100 ticks, print and
+//exit after 10 rounds.
+void TaskFunction1(void)
+{
+    while (counter1 < 10)
+    {
+        counter1++;
+
+        //signal task 2
+        SimpleOS_semaphoreSignal(&task2Flag);
+        SimpleOS_delay(100);
+    }
+
+    SimpleOS_EnterCritical();
+
+    printf("counters: %lu %lu %lu %lu\n", (unsigned long)counter1,
+            (unsigned long)counter2, (unsigned long)counter3, (unsigned long)counter4);
+
+    for (uint8_t i = 0 ; i < MAXTHREADS ; i++)
+        printf("thread %u: %u words used, overflow %u\n", i,
+                SimpleOS_getStackUsed(i), SimpleOS_getStackOverflow(i));
+
+    exit(0);
+}
+
+//////////////////////////////////////////////
+//TaskFunction2
+//Blocked until task 1 signals
+void TaskFunction2(void)
+{
+    while (1)
+    {
+        SimpleOS_semaphoreWait(&task2Flag);
+        counter2++;
+    }
+}
+
+
+//////////////////////////////////////////////
+//TaskFunction3
+void TaskFunction3(void)
+{
+    while (1)
+    {
+        counter3++;
+        SimpleOS_delay(100);
+    }
+}
+
+//////////////////////////////////////////////
+//TaskFunction4
+void TaskFunction4(void)
+{
+    while (1)
+    {
+        counter4++;
+        SimpleOS_delay(100);
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * test_fairness.c
+ *
+ *  Checks that SimpleOS shares the cpu fairly on the
+ *  POSIX port.  Built with SIMPLEOS_LOAD so the tick
+ *  counts the ticks each thread runs.
+ *
+ *  spin  - three threads at the same priority that
+ *          never give up the cpu.  The round robin has
+ *          to give each a third of the ticks, within
+ *          TEST_SPIN_SLACK percent.
+ *  yield - three threads at the same priority that
+ *          count and yield.  Each yield goes to the
+ *          next one in line, so the counts have to be
+ *          within TEST_YIELD_SLACK percent of each other.
+ *  lower - two of the spinning threads with one more
+ *          at a lower priority.  It must not run at all
+ *          while they're ready.
+ *
+ *  Each case runs for TEST_TICKS.  Prints PASS or FAIL
+ *  and exits with 1 on a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE, MAXTHREADS
+#include "bench.h"
+
+#define TEST_TICKS          600
+#define TEST_THREADS        3           //MAXTHREADS less the main thread
+#define TEST_SPIN_SLACK     5           //percent
+#define TEST_YIELD_SLACK    2
+
+static void Test_main(void);
+static void Test_spin(void);
+static void Test_yield(void);
+static void Test_lower(void);
+static int Test_case(const char* name, void (*function)(void), uint8_t slack);
+static int Test_lowerCase(void);
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stacks[TEST_THREADS][STACK_SIZE];
+
+static volatile uint8_t gStop = 0;
+static volatile uint32_t gCount[MAXTHREADS];
+static volatile uint32_t gLowerCount = 0;
+
+
+int main(void)
+{
+    if (SimpleOS_init(Test_main, 0, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+static void Test_main(void)
+{
+    int errors = 0;
+
+    Bench_print("case   thread 1 thread 2 thread 3, %u ticks, run ticks for spin, counts for yield\n", TEST_TICKS);
+
+    errors += Test_case("spin", Test_spin, TEST_SPIN_SLACK);
+    errors += Test_case("yield", Test_yield, TEST_YIELD_SLACK);
+    errors += Test_lowerCase();
+
+    Bench_print("%s\n", errors ? "FAIL" : "PASS");
+
+    exit(errors ? 1 : 0);
+}
+
+
+//////////////////////////////////////////////
+//Test_case
+//Run TEST_THREADS copies of function at priority
+//1 for TEST_TICKS.  spin checks the run ticks,
+//yield the counts.  Returns 1 if they're further
+//apart than slack percent.
+static int Test_case(const char* name, void (*function)(void), uint8_t slack)
+{
+    int thread[TEST_THREADS];
+    uint32_t share[TEST_THREADS];
+    uint32_t total = 0, low = 0xFFFFFFFF, high = 0;
+    uint8_t i;
+
+    gStop = 0;
+
+    for (i = 0 ; i < TEST_THREADS ; i++)
+    {
+        thread[i] = SimpleOS_addThread(function, 1, stacks[i], STACK_SIZE);
+        gCount[thread[i]] = 0;
+    }
+
+    SimpleOS_resetLoad();
+    SimpleOS_delay(TEST_TICKS);
+
+    for (i = 0 ; i < TEST_THREADS ; i++)
+    {
+        if (function == Test_spin)
+            share[i] = SimpleOS_getRunTicks(thread[i]);
+        else
+            share[i] = gCount[thread[i]];
+    }
+
+    gStop = 1;
+
+    for (i = 0 ; i < TEST_THREADS ; i++)
+        SimpleOS_join(thread[i]);
+
+    for (i = 0 ; i < TEST_THREADS ; i++)
+    {
+        total += share[i];
+        low = (share[i] < low) ? share[i] : low;
+        high = (share[i] > high) ? share[i] : high;
+    }
+
+    Bench_print("%-6s %8lu %8lu %8lu", name, (unsigned long)share[0],
+            (unsigned long)share[1], (unsigned long)share[2]);
+
+    if ((total == 0) || ((uint64_t)(high - low) * 100 * TEST_THREADS > (uint64_t)total * slack))
+    {
+        Bench_print("  more than %u%% apart\n", slack);
+        return 1;
+    }
+
+    Bench_print("\n");
+    return 0;
+}
+
+
+//////////////////////////////////////////////
+//Test_lowerCase
+//Spinning threads at priority 1 and one at 2.
+//Returns 1 if the one at 2 ran.
+static int Test_lowerCase(void)
+{
+    int thread[TEST_THREADS];
+    int lower;
+    uint32_t count;
+    uint8_t i;
+
+    gStop = 0;
+    gLowerCount = 0;
+
+    //the main thread, two spinning and the lower
+    //one use up the MAXTHREADS blocks
+    for (i = 0 ; i < TEST_THREADS - 1 ; i++)
+        thread[i] = SimpleOS_addThread(Test_spin, 1, stacks[i], STACK_SIZE);
+
+    lower = SimpleOS_addThread(Test_lower, 2, stacks[TEST_THREADS - 1], STACK_SIZE);
+
+    SimpleOS_delay(TEST_TICKS);
+
+    count = gLowerCount;
+    gStop = 1;
+
+    for (i = 0 ; i < TEST_THREADS - 1 ; i++)
+        SimpleOS_join(thread[i]);
+
+    SimpleOS_join(lower);
+
+    Bench_print("lower  %8lu runs at the lower priority", (unsigned long)count);
+
+    if (count)
+    {
+        Bench_print("  should be 0\n");
+        return 1;
+    }
+
+    Bench_print("\n");
+    return 0;
+}
+
+
+//////////////////////////////////////////////
+//Thread functions.  RunPt is the thread that's
+//running, its index is the thread number.
+extern TaskStruct* RunPt;
+
+static void Test_spin(void)
+{
+    uint8_t index = RunPt->index;
+
+    while (!gStop)
+        gCount[index]++;
+}
+
+
+static void Test_yield(void)
+{
+    uint8_t index = RunPt->index;
+
+    while (!gStop)
+    {
+        gCount[index]++;
+        SimpleOS_yield();
+    }
+}
+
+
+static void Test_lower(void)
+{
+    while (!gStop)
+        gLowerCount++;
+}
@@ -0,0 +1,189 @@
+/*
+ * test_mutex.c
+ *
+ *  Priority inheritance of the SimpleOS mutex on the
+ *  POSIX port, the low / middle / high inversion case.
+ *
+ *  low locks two mutexes and holds them for TEST_HOLD
+ *  ticks.  high and mid are added while it does.  high
+ *  blocks on the first mutex, so low has to run at
+ *  high's priority and mid, which is ready the whole
+ *  time, can't get in.  Checks that:
+ *
+ *  - low runs at high's priority while high waits
+ *  - low stays up after unlocking the second mutex and
+ *    drops back to it's own priority after the last one
+ *  - high gets the mutex when low unlocks it, and mid
+ *    only runs after that
+ *  - unlocking a mutex this thread doesn't own, locked
+ *    by another or not locked at all, returns -1
+ *
+ *  Prints the order things happened in, then PASS or
+ *  FAIL.  Exits with 1 on a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE, TaskStruct
+#include "bench.h"
+
+#define TEST_HOLD           20          //ticks low holds the mutexes
+#define TEST_MAIN           0           //priorities
+#define TEST_HIGH           1
+#define TEST_MID            2
+#define TEST_LOW            3
+
+enum
+{
+    TEST_LOW_LOCKED,
+    TEST_LOW_UNLOCKED,
+    TEST_HIGH_LOCKED,
+    TEST_MID_RAN,
+    TEST_EVENTS
+};
+
+static const char* const TestEventName[TEST_EVENTS] =
+{
+    "low locked", "low unlocked", "high locked", "mid ran"
+};
+
+static void Test_main(void);
+static void Test_low(void);
+static void Test_mid(void);
+static void Test_high(void);
+static void Test_event(uint8_t event);
+static void Test_check(int ok, const char* what);
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stackLow[STACK_SIZE];
+static int16_t stackMid[STACK_SIZE];
+static int16_t stackHigh[STACK_SIZE];
+
+static MutexStruct gMutex;
+static MutexStruct gOther;
+static volatile uint8_t gOrder[TEST_EVENTS];
+static volatile uint8_t gNext = 1;          //0 is not happened
+static volatile int gErrors = 0;
+
+extern TaskStruct* RunPt;
+
+
+int main(void)
+{
+    if (SimpleOS_init(Test_main, TEST_MAIN, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+static void Test_main(void)
+{
+    int low, mid, high;
+    uint8_t i;
+
+    SimpleOS_mutexInit(&gMutex);
+    SimpleOS_mutexInit(&gOther);
+
+    Test_check(SimpleOS_mutexUnlock(&gMutex) == -1, "unlock when not locked");
+
+    low = SimpleOS_addThread(Test_low, TEST_LOW, stackLow, STACK_SIZE);
+
+    //let low take the mutexes
+    while (!gOrder[TEST_LOW_LOCKED])
+        SimpleOS_delay(1);
+
+    Test_check(SimpleOS_mutexUnlock(&gMutex) == -1, "unlock by a thread that isn't the owner");
+
+    mid = SimpleOS_addThread(Test_mid, TEST_MID, stackMid, STACK_SIZE);
+    high = SimpleOS_addThread(Test_high, TEST_HIGH, stackHigh, STACK_SIZE);
+
+    SimpleOS_join(high);
+    SimpleOS_join(mid);
+    SimpleOS_join(low);
+
+    Bench_print("order:");
+
+    for (i = 0 ; i < TEST_EVENTS ; i++)
+        Bench_print(" %u %s%s", gOrder[i], TestEventName[i], (i < TEST_EVENTS - 1) ? "," : "\n");
+
+    Test_check(gOrder[TEST_LOW_UNLOCKED] < gOrder[TEST_HIGH_LOCKED], "high gets the mutex when low unlocks");
+    Test_check(gOrder[TEST_HIGH_LOCKED] < gOrder[TEST_MID_RAN], "mid runs after high has the mutex");
+
+    Bench_print("%s\n", gErrors ? "FAIL" : "PASS");
+
+    exit(gErrors ? 1 : 0);
+}
+
+
+//////////////////////////////////////////////
+//Test_low
+//Hold both mutexes for TEST_HOLD ticks without
+//giving up the cpu, then unlock the second one
+//and the first.
+static void Test_low(void)
+{
+    uint32_t start;
+
+    SimpleOS_mutexLock(&gMutex);
+    SimpleOS_mutexLock(&gOther);
+    Test_event(TEST_LOW_LOCKED);
+
+    start = gTimerTick;
+
+    while (gTimerTick - start < TEST_HOLD)
+        ;
+
+    Test_check(RunPt->priority == TEST_HIGH, "low runs at high's priority while high waits");
+
+    Test_check(SimpleOS_mutexUnlock(&gOther) == 0, "low unlocks the second mutex");
+    Test_check(RunPt->priority == TEST_HIGH, "low stays up while it holds a mutex");
+
+    Test_event(TEST_LOW_UNLOCKED);
+    Test_check(SimpleOS_mutexUnlock(&gMutex) == 0, "low unlocks the first mutex");
+
+    Test_check(RunPt->priority == TEST_LOW, "low back to it's own priority after the last unlock");
+}
+
+
+static void Test_mid(void)
+{
+    Test_event(TEST_MID_RAN);
+}
+
+
+static void Test_high(void)
+{
+    SimpleOS_mutexLock(&gMutex);
+    Test_event(TEST_HIGH_LOCKED);
+
+    Test_check(RunPt->priority == TEST_HIGH, "high keeps it's priority");
+    Test_check(SimpleOS_mutexUnlock(&gMutex) == 0, "high unlocks");
+}
+
+
+//////////////////////////////////////////////
+//Test_event
+//Number the events in the order they happen.
+static void Test_event(uint8_t event)
+{
+    SimpleOS_EnterCritical();
+    gOrder[event] = gNext++;
+    SimpleOS_ExitCritical();
+}
+
+
+static void Test_check(int ok, const char* what)
+{
+    if (!ok)
+    {
+        Bench_print("%s: failed\n", what);
+        gErrors++;
+    }
+}
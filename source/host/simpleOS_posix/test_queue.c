@@ -0,0 +1,216 @@
+/*
+ * test_queue.c
+ *
+ *  Producer / consumer stress test of the SimpleOS message
+ *  queues on the POSIX port, with the throughput.
+ *
+ *  A producer thread sends TEST_MESSAGES numbered messages
+ *  with SimpleOS_queueSend(), a consumer takes them with
+ *  SimpleOS_queueReceive(), both waiting forever.  The
+ *  consumer checks that each one is the next number.  Run
+ *  for a mailbox (size 1) and bigger queues, with the
+ *  consumer above, at and below the producer's priority,
+ *  so both sides block on the other.  The slow case has
+ *  the consumer sleep a tick every few messages, so the
+ *  producer waits on a full queue.
+ *
+ *  Then the timeouts: a receive on an empty queue and a
+ *  send to a full one have to come back with -1, right
+ *  away for a timeout of 0 and after the ticks asked for
+ *  otherwise.
+ *
+ *  Prints messages per second for each case, then PASS
+ *  or FAIL.  Exits with 1 on a failure.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "SimpleOS.h"
+#include "Task.h"            //STACK_SIZE
+#include "bench.h"
+
+#define TEST_MESSAGES       20000
+#define TEST_QUEUE_MAX      16
+#define TEST_SLOW_EVERY     100         //messages between sleeps in the slow case
+#define TEST_TIMEOUT        5           //ticks
+
+static void Test_main(void);
+static void Test_producer(void);
+static void Test_consumer(void);
+static int Test_run(uint8_t size, uint8_t consumerPriority, uint8_t slow);
+static int Test_timeouts(void);
+
+static int16_t stackMain[STACK_SIZE];
+static int16_t stackProducer[STACK_SIZE];
+static int16_t stackConsumer[STACK_SIZE];
+
+static QueueStruct gQueue;
+static int16_t gBuffer[TEST_QUEUE_MAX];
+static uint8_t gSlow = 0;
+static volatile uint32_t gReceived = 0;
+static volatile uint32_t gBad = 0;
+static volatile uint32_t gFailed = 0;
+
+
+int main(void)
+{
+    if (SimpleOS_init(Test_main, 0, stackMain, STACK_SIZE) < 0)
+        return 1;
+
+    SimpleOS_launch();
+
+    return 1;
+}
+
+
+static void Test_main(void)
+{
+    int errors = 0;
+
+    Bench_print("queue producer / consumer, %u messages, producer at priority 2\n", TEST_MESSAGES);
+    Bench_print("size  consumer  slow     msgs/s\n");
+
+    errors += Test_run(1, 1, 0);
+    errors += Test_run(1, 2, 0);
+    errors += Test_run(1, 3, 0);
+    errors += Test_run(4, 1, 0);
+    errors += Test_run(4, 2, 0);
+    errors += Test_run(4, 3, 0);
+    errors += Test_run(16, 1, 0);
+    errors += Test_run(16, 2, 0);
+    errors += Test_run(16, 3, 0);
+    errors += Test_run(16, 2, 1);
+
+    errors += Test_timeouts();
+
+    Bench_print("%s\n", errors ? "FAIL" : "PASS");
+
+    exit(errors ? 1 : 0);
+}
+
+
+//////////////////////////////////////////////
+//Test_run
+//One producer / consumer run.  Returns 1 if a
+//message was lost, out of order or a call failed.
+static int Test_run(uint8_t size, uint8_t consumerPriority, uint8_t slow)
+{
+    int producer, consumer;
+    uint64_t ns;
+
+    SimpleOS_queueInit(&gQueue, gBuffer, size);
+    gSlow = slow;
+    gReceived = 0;
+    gBad = 0;
+    gFailed = 0;
+
+    ns = Bench_now();
+
+    consumer = SimpleOS_addThread(Test_consumer, consumerPriority, stackConsumer, STACK_SIZE);
+    producer = SimpleOS_addThread(Test_producer, 2, stackProducer, STACK_SIZE);
+
+    SimpleOS_join(producer);
+    SimpleOS_join(consumer);
+
+    ns = Bench_now() - ns;
+
+    Bench_print("%4u  %8u  %4s  %9.0f", size, consumerPriority, slow ? "yes" : "no",
+            gReceived * 1e9 / ns);
+
+    if ((gReceived != TEST_MESSAGES) || gBad || gFailed || gQueue.count)
+    {
+        Bench_print("  received %lu, %lu out of order, %lu failed calls\n", (unsigned long)gReceived,
+                (unsigned long)gBad, (unsigned long)gFailed);
+        return 1;
+    }
+
+    Bench_print("\n");
+    return 0;
+}
+
+
+//////////////////////////////////////////////
+//Test_producer
+//Numbers wrap at 0x7FFF to stay in an int16_t.
+static void Test_producer(void)
+{
+    uint32_t i;
+
+    for (i = 0 ; i < TEST_MESSAGES ; i++)
+    {
+        if (SimpleOS_queueSend(&gQueue, (int16_t)(i & 0x7FFF), SIMPLEOS_WAIT_FOREVER) < 0)
+            gFailed++;
+    }
+}
+
+
+static void Test_consumer(void)
+{
+    int16_t msg;
+
+    while (gReceived < TEST_MESSAGES)
+    {
+        if (SimpleOS_queueReceive(&gQueue, &msg, SIMPLEOS_WAIT_FOREVER) < 0)
+        {
+            gFailed++;
+            return;
+        }
+
+        if (msg != (int16_t)(gReceived & 0x7FFF))
+            gBad++;
+
+        gReceived++;
+
+        if (gSlow && !(gReceived % TEST_SLOW_EVERY))
+            SimpleOS_delay(1);
+    }
+}
+
+
+//////////////////////////////////////////////
+//Test_timeouts
+//Run from the main thread, nothing else is
+//running.  Returns the number that failed.
+static int Test_timeouts(void)
+{
+    int errors = 0;
+    int16_t msg;
+    uint32_t ticks;
+
+    SimpleOS_queueInit(&gQueue, gBuffer, 1);
+
+    if (SimpleOS_queueReceive(&gQueue, &msg, 0) != -1)
+        errors++;
+
+    ticks = gTimerTick;
+
+    if (SimpleOS_queueReceive(&gQueue, &msg, TEST_TIMEOUT) != -1)
+        errors++;
+
+    if (gTimerTick - ticks < TEST_TIMEOUT)
+        errors++;
+
+    if (SimpleOS_queueSend(&gQueue, 1, 0) != 0)
+        errors++;
+
+    if (SimpleOS_queueSend(&gQueue, 2, 0) != -1)
+        errors++;
+
+    ticks = gTimerTick;
+
+    if (SimpleOS_queueSend(&gQueue, 2, TEST_TIMEOUT) != -1)
+        errors++;
+
+    if (gTimerTick - ticks < TEST_TIMEOUT)
+        errors++;
+
+    if ((SimpleOS_queueReceive(&gQueue, &msg, 0) != 0) || (msg != 1))
+        errors++;
+
+    Bench_print("timeouts  %s\n", errors ? "failed" : "ok");
+
+    return errors;
+}
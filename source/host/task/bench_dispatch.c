@@ -0,0 +1,179 @@
+/*
+ * bench_dispatch.c
+ *
+ *  Dispatch latency of the tasker scheduler loop against
+ *  the number of tasks, the ready set in common/task
+ *  against the old scan of the table (task_baseline.c).
+ *
+ *  The task with the highest index (lowest priority) is
+ *  the only one that gets ready, the worst case for the
+ *  scan.  The others are enabled with periods too long
+ *  to time out during the run.  The task runs the timer
+ *  isr itself so it's ready again, stamps the time and
+ *  returns.  The latency is from that stamp to the start
+ *  of its next run, so it covers the end of the last run
+ *  (the deadline check), picking the task and the call.
+ *  Both columns include a clock read, about the same
+ *  for each, and the median is printed to keep the
+ *  host's noise out.  The run ends with a longjmp out
+ *  of the scheduler loop.  Times are host ns.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <setjmp.h>
+
+#include "task.h"
+#include "task_baseline.h"
+#include "sim.h"
+
+#define BENCH_SAMPLES		50000UL		//less than the other tasks' period
+
+static jmp_buf BenchExit;
+static void (*BenchIsr)(void);
+static uint64_t BenchStamp;
+static uint32_t BenchLatency[BENCH_SAMPLES];
+static uint32_t BenchCount;
+
+static void Bench_Nop(void);
+static void Bench_Target(void);
+static void Bench_Start(void);
+static void Bench_Print(void);
+static int Bench_Compare(const void *a, const void *b);
+static void Bench_Task(uint8_t tasks);
+static void Bench_Base(uint8_t tasks);
+
+
+int main(void)
+{
+	static const uint8_t counts[] = {1, 2, 4, 8, 16};
+	uint8_t i;
+
+	printf("dispatch latency, ns from the isr to the task, %lu runs\n", BENCH_SAMPLES);
+	printf("            ready set              scan\n");
+	printf("tasks    median     min    median     min\n");
+
+	for (i = 0 ; i < sizeof(counts) ; i++)
+	{
+		printf("%5u", counts[i]);
+
+		Bench_Task(counts[i]);
+		Bench_Print();
+
+		Bench_Base(counts[i]);
+		Bench_Print();
+
+		printf("\n");
+	}
+
+	return 0;
+}
+
+
+static void Bench_Nop(void)
+{
+}
+
+
+///////////////////////////////////////////
+//Bench_Target
+//The lowest priority task.  Record the time
+//since the stamp, tick so it's ready again,
+//stamp and go back to the scheduler.
+//
+static void Bench_Target(void)
+{
+	uint64_t now = Sim_Now();
+
+	if (BenchCount > 0)
+		BenchLatency[BenchCount - 1] = (uint32_t)(now - BenchStamp);
+
+	if (++BenchCount > BENCH_SAMPLES)
+		longjmp(BenchExit, 1);
+
+	BenchIsr();
+	BenchStamp = Sim_Now();
+}
+
+
+static void Bench_Start(void)
+{
+	BenchCount = 0;
+}
+
+
+///////////////////////////////////////////
+//Bench_Print
+//Median and min of the last run.
+//
+static void Bench_Print(void)
+{
+	qsort(BenchLatency, BENCH_SAMPLES, sizeof(BenchLatency[0]), Bench_Compare);
+
+	printf("  %8lu %7lu", (unsigned long)BenchLatency[BENCH_SAMPLES / 2], (unsigned long)BenchLatency[0]);
+}
+
+
+static int Bench_Compare(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+
+///////////////////////////////////////////
+//Bench_Task
+//Ready set scheduler, the target has a period
+//of 1 tick so every isr makes it ready.
+//
+static void Bench_Task(uint8_t tasks)
+{
+	uint8_t i;
+
+	Bench_Start();
+	BenchIsr = Task_TimerISRHandler;
+
+	Task_Init();
+
+	for (i = 0 ; i + 1 < tasks ; i++)
+		Task_AddTask("other", Bench_Nop, 60000, i);
+
+	Task_AddTask("target", Bench_Target, 1, tasks - 1);
+
+	Task_TimerISRHandler();					//first run
+
+	if (!setjmp(BenchExit))
+		Task_StartScheduler();
+
+}
+
+
+///////////////////////////////////////////
+//Bench_Base
+//Old scheduler, a period of 0 runs every tick
+//there.  The table is sized to the tasks.
+//
+static void Bench_Base(uint8_t tasks)
+{
+	uint8_t i;
+
+	Bench_Start();
+	BenchIsr = Base_TimerISRHandler;
+
+	Base_Init(tasks);
+
+	for (i = 0 ; i + 1 < tasks ; i++)
+		Base_AddTask(Bench_Nop, 60000, i);
+
+	Base_AddTask(Bench_Target, 0, tasks - 1);
+
+	Base_TimerISRHandler();
+
+	if (!setjmp(BenchExit))
+		Base_StartScheduler();
+
+}
@@ -0,0 +1,107 @@
+/*
+ * bench_tick.c
+ *
+ *  Cost of the tasker timer isr against the number of
+ *  tasks, the delta list in common/task against the
+ *  old scan of the whole table (task_baseline.c).
+ *
+ *  Two loads for each task count:
+ *  quiet - every period is 60000 ticks, so no task
+ *          times out and the isr only counts down.
+ *  mixed - periods of 10, 17, 24.. ticks, so some
+ *          ticks pop and re-insert tasks.
+ *
+ *  The scheduler doesn't run, so the timeouts after
+ *  the first are coalesced periods.  The list work in
+ *  the isr is the same either way.  Times are host ns,
+ *  compare the columns, not the numbers against the
+ *  msp430.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "task.h"
+#include "task_baseline.h"
+#include "sim.h"
+
+#define BENCH_TICKS		2000000UL
+
+static void Bench_Nop(void);
+static double Bench_Task(uint8_t tasks, uint16_t period, uint16_t step);
+static double Bench_Base(uint8_t tasks, uint16_t period, uint16_t step);
+
+
+int main(void)
+{
+	static const uint8_t counts[] = {1, 2, 4, 8, 16};
+	uint8_t i;
+
+	printf("timer isr, ns per tick over %lu ticks\n", BENCH_TICKS);
+	printf("tasks   delta quiet   scan quiet   delta mixed   scan mixed\n");
+
+	for (i = 0 ; i < sizeof(counts) ; i++)
+	{
+		printf("%5u   %11.1f  %11.1f   %11.1f  %11.1f\n", counts[i],
+				Bench_Task(counts[i], 60000, 0), Bench_Base(counts[i], 60000, 0),
+				Bench_Task(counts[i], 10, 7), Bench_Base(counts[i], 10, 7));
+	}
+
+	return 0;
+}
+
+
+static void Bench_Nop(void)
+{
+}
+
+
+///////////////////////////////////////////
+//Bench_Task
+//ns per Task_TimerISRHandler() with tasks
+//tasks, task i has a period of period + i * step.
+//
+static double Bench_Task(uint8_t tasks, uint16_t period, uint16_t step)
+{
+	uint64_t start;
+	uint32_t n;
+	uint8_t i;
+
+	Task_Init();
+
+	for (i = 0 ; i < tasks ; i++)
+		Task_AddTask("bench", Bench_Nop, period + i * step, i);
+
+	start = Sim_Now();
+
+	for (n = 0 ; n < BENCH_TICKS ; n++)
+		Task_TimerISRHandler();
+
+	return (double)(Sim_Now() - start) / BENCH_TICKS;
+}
+
+
+///////////////////////////////////////////
+//Bench_Base
+//Same for the old isr, with the table sized
+//to the number of tasks.
+//
+static double Bench_Base(uint8_t tasks, uint16_t period, uint16_t step)
+{
+	uint64_t start;
+	uint32_t n;
+	uint8_t i;
+
+	Base_Init(tasks);
+
+	for (i = 0 ; i < tasks ; i++)
+		Base_AddTask(Bench_Nop, period + i * step, i);
+
+	start = Sim_Now();
+
+	for (n = 0 ; n < BENCH_TICKS ; n++)
+		Base_TimerISRHandler();
+
+	return (double)(Sim_Now() - start) / BENCH_TICKS;
+}
@@ -0,0 +1,207 @@
+/*
+ * bench_wake.c
+ *
+ *  Latency from a message post in an isr to the task
+ *  that takes it, with wake on message off and on.
+ *
+ *  The task set is msp430_vfo with guessed costs, like
+ *  tasksets/vfo.txt: rx every 100 ticks, led and display
+ *  every 500, the display run is 40 ticks.  A simulated
+ *  encoder isr posts to rx at pseudo random ticks, 20 to
+ *  139 ticks apart, the same sequence for both runs.
+ *  The message value is the tick of the post and rx
+ *  works out the latency for each message it takes.
+ *
+ *  Time is simulated the same way as task_sim, so the
+ *  numbers are in ticks (ms on the vfo) and come out the
+ *  same on every host.  The run ends with a longjmp out
+ *  of the scheduler loop.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <setjmp.h>
+
+#include <msp430.h>
+
+#include "task.h"
+#include "sim.h"
+
+#define BENCH_TICKS			100000UL
+#define BENCH_POST_MIN		20			//ticks between posts
+#define BENCH_POST_RANGE	120
+
+enum
+{
+	BENCH_ID_RX,
+	BENCH_ID_LED,
+	BENCH_ID_DISPLAY,
+};
+
+static jmp_buf BenchExit;
+static uint32_t BenchTicks;
+static uint32_t BenchNextPost;
+static uint32_t BenchSeed;
+static uint32_t BenchPosts;
+static uint32_t BenchTaken;
+static uint32_t BenchTotal;
+static uint32_t BenchMax;
+static uint32_t BenchHistogram[6];		//0, 1-9, 10-39, 40-69, 70-99, 100+
+
+static void Bench_Tick(void);
+static void Bench_Busy(uint16_t ticks);
+static void Bench_Rx(void);
+static void Bench_Led(void);
+static void Bench_Display(void);
+static void Bench_Run(uint8_t wake);
+static uint32_t Bench_Random(void);
+
+
+int main(void)
+{
+	printf("post to handler latency, vfo task set, %lu ticks%s\n", BENCH_TICKS,
+			TASK_TICKLESS ? ", tickless" : "");
+	printf("wake   posts    mean   max      0   1-9  10-39  40-69  70-99   100+\n");
+
+	Bench_Run(0);
+	Bench_Run(1);
+
+	return 0;
+}
+
+
+///////////////////////////////////////////
+//Bench_Run
+//One run of the task set from tick 0.
+//
+static void Bench_Run(uint8_t wake)
+{
+	uint8_t i;
+
+	BenchTicks = 0;
+	BenchSeed = 1;
+	BenchNextPost = BENCH_POST_MIN + Bench_Random() % BENCH_POST_RANGE;
+	BenchPosts = 0;
+	BenchTaken = 0;
+	BenchTotal = 0;
+	BenchMax = 0;
+
+	for (i = 0 ; i < sizeof(BenchHistogram) / sizeof(BenchHistogram[0]) ; i++)
+		BenchHistogram[i] = 0;
+
+	Task_Init();
+	Task_AddTask("rx", Bench_Rx, 100, BENCH_ID_RX);
+	Task_AddTask("led", Bench_Led, 500, BENCH_ID_LED);
+	Task_AddTask("display", Bench_Display, 500, BENCH_ID_DISPLAY);
+	Task_AttachMessageQueue(BENCH_ID_RX);
+	Task_SetMessageWake(BENCH_ID_RX, wake);
+
+	SimIdleHook = Bench_Tick;
+
+	if (!setjmp(BenchExit))
+		Task_StartScheduler();
+
+	printf("%-4s  %6lu  %6.1f  %4lu", wake ? "on" : "off", (unsigned long)BenchPosts,
+			BenchTaken ? (double)BenchTotal / BenchTaken : 0.0, (unsigned long)BenchMax);
+
+	for (i = 0 ; i < sizeof(BenchHistogram) / sizeof(BenchHistogram[0]) ; i++)
+		printf("  %5lu", (unsigned long)BenchHistogram[i]);
+
+	printf("\n");
+
+	//every post has to be taken or still waiting
+	if (BenchTaken + Task_GetNumMessageWaiting(BENCH_ID_RX) != BenchPosts)
+		printf("  lost %lu posts\n", (unsigned long)(BenchPosts - BenchTaken));
+}
+
+
+///////////////////////////////////////////
+//Bench_Tick
+//One timer interrupt, then the encoder isr
+//if it's time for a post.
+//
+static void Bench_Tick(void)
+{
+	TaskMessage msg;
+
+	if (BenchTicks >= BENCH_TICKS)
+		longjmp(BenchExit, 1);
+
+	Sim_TimerTick();
+	BenchTicks++;
+
+	if (BenchTicks == BenchNextPost)
+	{
+		msg.signal = TASK_SIG_DATA;
+		msg.value = (uint16_t)BenchTicks;
+
+		if (Task_SendMessage(BENCH_ID_RX, msg) > 0)
+			BenchPosts++;
+
+		TASK_WAKE_ON_EXIT();
+		BenchNextPost += BENCH_POST_MIN + Bench_Random() % BENCH_POST_RANGE;
+	}
+}
+
+
+static void Bench_Busy(uint16_t ticks)
+{
+	while (ticks--)
+		Bench_Tick();
+}
+
+
+static void Bench_Rx(void)
+{
+	TaskMessage msg;
+	uint16_t latency;
+
+	while (Task_GetNextMessage(BENCH_ID_RX, &msg) > 0)
+	{
+		latency = (uint16_t)BenchTicks - msg.value;
+
+		BenchTaken++;
+		BenchTotal += latency;
+
+		if (latency > BenchMax)
+			BenchMax = latency;
+
+		if (latency == 0)
+			BenchHistogram[0]++;
+		else if (latency < 10)
+			BenchHistogram[1]++;
+		else if (latency < 40)
+			BenchHistogram[2]++;
+		else if (latency < 70)
+			BenchHistogram[3]++;
+		else if (latency < 100)
+			BenchHistogram[4]++;
+		else
+			BenchHistogram[5]++;
+	}
+
+	Bench_Busy(2);
+}
+
+
+static void Bench_Led(void)
+{
+	Bench_Busy(1);
+}
+
+
+static void Bench_Display(void)
+{
+	Bench_Busy(40);
+}
+
+
+//same sequence on every host
+static uint32_t Bench_Random(void)
+{
+	BenchSeed = BenchSeed * 1103515245UL + 12345UL;
+
+	return (BenchSeed >> 16) & 0x7FFF;
+}
@@ -0,0 +1,55 @@
+/*
+ * msp430.h
+ *
+ *  Stand-in for the TI header when the tasker in
+ *  source/common/task is built on a host.  The
+ *  registers task.c touches are plain variables in
+ *  sim.c and the intrinsics work on a fake status
+ *  register, so nothing here talks to hardware.
+ *  The simulated isrs run inside the low power
+ *  loop in Sim_Sleep(), so clearing the bits on
+ *  exit clears them in SimSR.
+ *  -I. has to come before the system includes for
+ *  this one to be picked up.
+ *
+ */
+
+#ifndef HOST_MSP430_H_
+#define HOST_MSP430_H_
+
+#include <stdint.h>
+
+//status register bits
+#define GIE				0x0008
+#define CPUOFF			0x0010
+#define OSCOFF			0x0020
+#define SCG0			0x0040
+#define SCG1			0x0080
+#define LPM0_bits		(CPUOFF)
+#define LPM3_bits		(SCG1 | SCG0 | CPUOFF)
+
+//Timer_A bits used by the tickless and profile code
+#define CCIFG			0x0001
+#define TASSEL_2		0x0200
+#define ID_3			0x00C0
+#define MC_2			0x0020
+#define TACLR			0x0004
+
+extern volatile uint16_t SimSR;
+extern volatile uint16_t TAR;
+extern volatile uint16_t TACCR0;
+extern volatile uint16_t TACCTL0;
+extern volatile uint16_t TA1R;
+extern volatile uint16_t TA1CTL;
+
+void Sim_Sleep(uint16_t bits);		//sim.c
+
+#define __get_SR_register()					(SimSR)
+#define __disable_interrupt()				(SimSR &= ~GIE)
+#define __enable_interrupt()				(SimSR |= GIE)
+#define __bis_SR_register(bits)				Sim_Sleep(bits)
+#define __bic_SR_register(bits)				(SimSR &= ~(bits))
+#define __bic_SR_register_on_exit(bits)		(SimSR &= ~(bits))
+#define __no_operation()					((void)0)
+
+#endif /* HOST_MSP430_H_ */
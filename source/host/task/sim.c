@@ -0,0 +1,103 @@
+/*
+ * sim.c
+ *
+ *  Host side of the tasker builds, see sim.h.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#include <msp430.h>
+#include "task.h"
+#include "sim.h"
+
+//////////////////////////////////////////
+//Fake registers for msp430.h.  Interrupts
+//start enabled and TACCR0 is set for the
+//fixed tick, like after Task_Init() and the
+//timer setup in main.
+volatile uint16_t SimSR = GIE;
+volatile uint16_t TAR = 0;
+volatile uint16_t TACCR0 = TASK_TICK_COUNTS - 1;
+volatile uint16_t TACCTL0 = 0;
+volatile uint16_t TA1R = 0;
+volatile uint16_t TA1CTL = 0;
+
+void (*SimIdleHook)(void) = NULL;
+uint32_t SimTimerIsrs = 0;
+
+
+///////////////////////////////////////////
+//Sim_Now
+//Monotonic host time in ns, for the benchmarks.
+//
+uint64_t Sim_Now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+
+///////////////////////////////////////////
+//Sim_Idle
+//The scheduler has nothing ready.  A
+//simulation sets SimIdleHook to run the
+//timer isr, otherwise the loop just spins.
+//
+void Sim_Idle(void)
+{
+	if (SimIdleHook != NULL)
+		SimIdleHook();
+}
+
+
+///////////////////////////////////////////
+//Sim_TimerTick
+//One tick of Timer_A counts.  Without tickless
+//every tick is an interrupt.  With it, TAR counts
+//up to TACCR0 and the isr only runs when it rolls
+//over, one interrupt for the whole period the
+//scheduler programmed.  Same as the Timer_A isr
+//in the projects, it wakes the scheduler on exit.
+//
+void Sim_TimerTick(void)
+{
+#if TASK_TICKLESS
+	uint32_t count = (uint32_t)TAR + TASK_TICK_COUNTS;
+
+	if (count <= TACCR0)
+	{
+		TAR = (uint16_t)count;
+		return;
+	}
+
+	TAR = 0;
+	SimTimerIsrs++;
+#endif
+
+	Task_TimerISRHandler();
+	TASK_WAKE_ON_EXIT();
+}
+
+
+///////////////////////////////////////////
+//Sim_Sleep
+//__bis_SR_register(), only the tickless idle
+//uses it.  The low power bits stay set until
+//an isr clears them on exit, the time moves
+//on through the idle hook meanwhile.
+//
+void Sim_Sleep(uint16_t bits)
+{
+	SimSR |= bits;
+
+	while (SimSR & CPUOFF)
+		Sim_Idle();
+}
@@ -0,0 +1,23 @@
+/*
+ * sim.h
+ *
+ *  Host side of the tasker builds.  The fake msp430
+ *  registers, a clock for timing on the host, the
+ *  simulated Timer_A and the idle hook the simulations
+ *  use to move time on.
+ *
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+
+extern void (*SimIdleHook)(void);	//run by Sim_Idle(), NULL for none
+extern uint32_t SimTimerIsrs;		//tickless timer interrupts so far
+
+uint64_t Sim_Now(void);			//host clock in ns
+void Sim_Idle(void);			//TASK_IDLE_HOOK() in task_config.h
+void Sim_TimerTick(void);		//one tick, runs the timer isr when it's due
+
+#endif /* HOST_SIM_H_ */
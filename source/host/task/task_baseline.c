@@ -0,0 +1,124 @@
+/*
+ * task_baseline.c
+ *
+ *  The old tasker, see task_baseline.h.  The isr and
+ *  the scheduler loop are the original code, only the
+ *  loops run to BaseSize instead of TASK_MAX_TASK.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "task_baseline.h"
+
+typedef struct
+{
+	uint16_t initialTimeTick;	//countdown value
+	uint16_t timer;				//frequency to run task
+	uint8_t flagRun;			//running or not running
+	uint8_t flagEnable;			//enable task
+	uint8_t index;				//index in the task table
+	void (* taskFunction) (void);		//function pointer
+
+}BaseStruct;
+
+static BaseStruct BaseTable[BASE_MAX_TASK];
+static uint8_t BaseSize = BASE_MAX_TASK;
+
+
+///////////////////////////////////////
+//Init task table with default values,
+//size slots are used
+void Base_Init(uint8_t size)
+{
+	uint8_t i;
+
+	BaseSize = (size < BASE_MAX_TASK) ? size : BASE_MAX_TASK;
+
+	for (i = 0 ; i < BASE_MAX_TASK ; i++)
+	{
+		BaseTable[i].taskFunction = NULL;
+		BaseTable[i].timer = 0;
+		BaseTable[i].flagEnable = 0;
+		BaseTable[i].flagRun = 0;
+		BaseTable[i].index = i;
+		BaseTable[i].initialTimeTick = 0;
+	}
+}
+
+
+int Base_AddTask(void (*taskFunction) (void), uint16_t time, uint8_t priority)
+{
+	if (priority < BaseSize)
+	{
+		if (BaseTable[priority].taskFunction == NULL)
+		{
+			BaseTable[priority].flagEnable = 1;
+			BaseTable[priority].flagRun = 0;
+			BaseTable[priority].index = priority;
+			BaseTable[priority].initialTimeTick = time;
+			BaseTable[priority].taskFunction = taskFunction;
+			BaseTable[priority].timer = time;
+
+			return 1;
+		}
+	}
+
+	return -1;
+}
+
+
+/////////////////////////////////////////
+//Main loop routine, the original scan of
+//the whole table.  Never returns, the task
+//functions end the benchmark.
+void Base_StartScheduler(void)
+{
+	uint8_t i = 0;
+
+	while (1)
+	{
+		for (i = 0; i < BaseSize ; i++)
+		{
+			if (BaseTable[i].taskFunction != NULL)
+			{
+				if (BaseTable[i].flagEnable == 1)
+				{
+					if (BaseTable[i].flagRun == 1)
+					{
+						BaseTable[i].flagRun = 0;
+
+						BaseTable[i].taskFunction();
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+
+//////////////////////////////////////
+//Loop over the task table, decrementing
+//the timeTick and set the run flag for
+//those timers that have rolled over.
+//A task runs every timer + 1 ticks.
+void Base_TimerISRHandler(void)
+{
+	uint8_t i;
+	for (i = 0 ; i < BaseSize ; i++)
+	{
+		if ((BaseTable[i].flagEnable == 1) && (BaseTable[i].taskFunction != NULL))
+		{
+			if (!BaseTable[i].initialTimeTick)
+			{
+				BaseTable[i].flagRun = 1;
+				BaseTable[i].initialTimeTick = BaseTable[i].timer;
+			}
+
+			else
+				BaseTable[i].initialTimeTick--;
+		}
+	}
+}
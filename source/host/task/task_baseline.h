@@ -0,0 +1,25 @@
+/*
+ * task_baseline.h
+ *
+ *  The tasker timer isr and scheduler loop as they
+ *  were before the delta list and the ready set
+ *  (msp430_task1/task before the shared library), for
+ *  the benchmarks to compare against.  The table size
+ *  is set at run time so the cost can be measured for
+ *  different TASK_MAX_TASK.
+ *
+ */
+
+#ifndef HOST_TASK_BASELINE_H_
+#define HOST_TASK_BASELINE_H_
+
+#include <stdint.h>
+
+#define BASE_MAX_TASK		16
+
+void Base_Init(uint8_t size);
+int Base_AddTask(void (*taskFunction) (void), uint16_t time, uint8_t priority);
+void Base_TimerISRHandler(void);
+void Base_StartScheduler(void);
+
+#endif /* HOST_TASK_BASELINE_H_ */
@@ -0,0 +1,58 @@
+/*
+ * task_config.h
+ *
+ *  Tasker settings for the host builds.  Everything
+ *  but tickless and profiling is turned on, with the
+ *  largest table, so one build covers the tests and
+ *  benchmarks.  The Makefile sets TASK_SCHED_MODE,
+ *  TASK_TICKLESS for the _tickless builds and
+ *  TASK_PROFILE for test_profile.
+ *  See common/task/task.h for the options.
+ *
+ */
+
+#ifndef TASK_CONFIG_H_
+#define TASK_CONFIG_H_
+
+#include <stdint.h>
+
+#define TASK_MAX_TASK		16
+#define TASK_USE_NAMES		1
+#define TASK_USE_MESSAGES	1
+#define TASK_MESSAGE_SIZE	8			//ring buffer size, power of 2
+#define TASK_MESSAGE_QUEUES	4
+#define TASK_MESSAGE_VALUE_TYPE	uint16_t
+#define TASK_MESSAGE_WAKE	1
+
+#ifndef TASK_TICKLESS
+#define TASK_TICKLESS		0
+#endif
+#ifndef TASK_SCHED_MODE
+#define TASK_SCHED_MODE		TASK_SCHED_PRIORITY
+#endif
+#ifndef TASK_PROFILE
+#define TASK_PROFILE		0
+#endif
+
+void Sim_Idle(void);
+#define TASK_IDLE_HOOK()	Sim_Idle()		//see sim.c
+
+
+typedef enum
+{
+	TASK_SIG_NONE,		//do nothing
+	TASK_SIG_DATA,		//value is a sequence number
+	TASK_SIG_LAST,
+
+}TaskSignal_t;
+
+
+//the host programs number their own tasks
+typedef enum
+{
+	TASK_ID_LAST = TASK_MAX_TASK,
+
+}TaskID_t;
+
+
+#endif /* TASK_CONFIG_H_ */
@@ -0,0 +1,427 @@
+/*
+ * task_sim.c
+ *
+ *  Replays a task set through the real scheduler loop in
+ *  common/task and checks the schedule.  Built twice by
+ *  the Makefile, task_sim_priority and task_sim_edf, one
+ *  for each TASK_SCHED_MODE.
+ *
+ *  Time is in ticks and only moves when the timer ticks
+ *  (Sim_TimerTick).  A task that costs c ticks ticks it c
+ *  times while it "runs", the same as the real timer
+ *  interrupting it.  When nothing is ready the idle hook
+ *  ticks it once.  The _tickless builds only take the isr
+ *  when the period the scheduler programmed in TACCR0 runs
+ *  out, and the idle sleeps until then, so the schedule
+ *  has to come out the same as with the fixed tick.
+ *
+ *  The task set file, one entry per line, # for comments:
+ *
+ *  task <name> <period> <cost>     - in priority order, the
+ *                                    first one is index 0
+ *  ticks <n>                       - how long to run
+ *  expect <mode> <name> <stat> <max> - fail if stat > max,
+ *                                    mode is priority, edf or *
+ *
+ *  stat is runs, latency (most ticks from a timeout to the
+ *  start of the run), missed or coalesced.  A period of 0
+ *  times out every tick, the same as 1.
+ *
+ *  The simulation keeps it's own count of the timeouts,
+ *  so missed deadlines and coalesced periods are worked out
+ *  twice, here and by the tasker.  Any difference is an
+ *  error too.  -v prints every run.
+ *
+ *  Exits with 1 on a bad file, a failed expect or a count
+ *  that doesn't match.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "task.h"
+#include "sim.h"
+
+#if TASK_SCHED_MODE == TASK_SCHED_EDF
+#define SIM_MODE			"edf"
+#else
+#define SIM_MODE			"priority"
+#endif
+
+#if TASK_TICKLESS
+#define SIM_TICK			"tickless"
+#else
+#define SIM_TICK			"fixed tick"
+#endif
+
+#define SIM_NAME_LENGTH		16
+#define SIM_EXPECTS			32
+
+//period 0 runs every tick, like the tasker
+#define SIM_PERIOD(task)	((task)->period ? (task)->period : 1)
+
+typedef struct
+{
+	char name[SIM_NAME_LENGTH];
+	uint16_t period;
+	uint16_t cost;
+	uint32_t served;			//timeouts up to and including this one are served
+	uint32_t runs;
+	uint32_t latency;			//most ticks from the timeout to the start
+	uint32_t missed;
+	uint32_t coalesced;
+}SimTask;
+
+typedef struct
+{
+	char mode[SIM_NAME_LENGTH];
+	char name[SIM_NAME_LENGTH];
+	char stat[SIM_NAME_LENGTH];
+	uint32_t max;
+}SimExpect;
+
+static SimTask SimTasks[TASK_MAX_TASK];
+static uint8_t SimTaskCount = 0;
+static SimExpect SimExpects[SIM_EXPECTS];
+static uint8_t SimExpectCount = 0;
+static uint32_t SimTicks = 0;
+static uint32_t SimEnd = 0;
+static uint8_t SimVerbose = 0;
+static int SimErrors = 0;
+static jmp_buf SimExit;
+
+static int Sim_Load(const char *file);
+static void Sim_Tick(void);
+static void Sim_Run(uint8_t index);
+static int Sim_Report(void);
+static int Sim_Find(const char *name);
+static uint32_t Sim_Stat(const SimTask *task, const char *stat, int *ok);
+
+//one function per slot so the task knows it's index
+#define SIM_TASK(n)		static void Sim_Task##n(void) { Sim_Run(n); }
+SIM_TASK(0)  SIM_TASK(1)  SIM_TASK(2)  SIM_TASK(3)
+SIM_TASK(4)  SIM_TASK(5)  SIM_TASK(6)  SIM_TASK(7)
+SIM_TASK(8)  SIM_TASK(9)  SIM_TASK(10) SIM_TASK(11)
+SIM_TASK(12) SIM_TASK(13) SIM_TASK(14) SIM_TASK(15)
+
+static void (* const SimFunction[16]) (void) =
+{
+	Sim_Task0,  Sim_Task1,  Sim_Task2,  Sim_Task3,
+	Sim_Task4,  Sim_Task5,  Sim_Task6,  Sim_Task7,
+	Sim_Task8,  Sim_Task9,  Sim_Task10, Sim_Task11,
+	Sim_Task12, Sim_Task13, Sim_Task14, Sim_Task15,
+};
+
+
+int main(int argc, char *argv[])
+{
+	const char *file = NULL;
+	uint8_t i;
+	int arg;
+
+	for (arg = 1 ; arg < argc ; arg++)
+	{
+		if (!strcmp(argv[arg], "-v"))
+			SimVerbose = 1;
+		else
+			file = argv[arg];
+	}
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "usage: %s [-v] taskset\n", argv[0]);
+		return 1;
+	}
+
+	if (Sim_Load(file) < 0)
+		return 1;
+
+	Task_Init();
+
+	for (i = 0 ; i < SimTaskCount ; i++)
+		Task_AddTask(SimTasks[i].name, SimFunction[i], SimTasks[i].period, i);
+
+	SimIdleHook = Sim_Tick;
+
+	if (!setjmp(SimExit))
+		Task_StartScheduler();
+
+	printf("task_sim %s, %s: %s, %lu ticks\n", SIM_MODE, SIM_TICK, file, (unsigned long)SimEnd);
+
+#if TASK_TICKLESS
+	printf("%lu timer isrs, %lu ticks asleep\n", (unsigned long)SimTimerIsrs,
+			(unsigned long)Task_GetSleepTicks());
+#endif
+
+	return Sim_Report();
+}
+
+
+///////////////////////////////////////////
+//Sim_Load
+//Read the task set.  Returns -1 on an
+//error in the file.
+//
+static int Sim_Load(const char *file)
+{
+	FILE *in = fopen(file, "r");
+	char line[128];
+	char word[SIM_NAME_LENGTH];
+	unsigned period, cost;
+	unsigned long value;
+	int number = 0;
+	SimTask *task;
+	SimExpect *expect;
+
+	if (in == NULL)
+	{
+		perror(file);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		number++;
+
+		if ((sscanf(line, "%15s", word) != 1) || (word[0] == '#'))
+			continue;
+
+		if (!strcmp(word, "task") && (SimTaskCount < TASK_MAX_TASK))
+		{
+			task = &SimTasks[SimTaskCount];
+			memset(task, 0, sizeof(*task));
+
+			if ((sscanf(line, "%*s %15s %u %u", task->name, &period, &cost) == 3) && (period <= 0xFFFF) && (cost <= 0xFFFF))
+			{
+				task->period = period;
+				task->cost = cost;
+				SimTaskCount++;
+				continue;
+			}
+		}
+
+		else if (!strcmp(word, "ticks") && (sscanf(line, "%*s %lu", &value) == 1))
+		{
+			SimEnd = value;
+			continue;
+		}
+
+		else if (!strcmp(word, "expect") && (SimExpectCount < SIM_EXPECTS))
+		{
+			expect = &SimExpects[SimExpectCount];
+
+			if (sscanf(line, "%*s %15s %15s %15s %lu", expect->mode, expect->name, expect->stat, &value) == 4)
+			{
+				expect->max = value;
+				SimExpectCount++;
+				continue;
+			}
+		}
+
+		fprintf(stderr, "%s:%d: can't read this line\n", file, number);
+		fclose(in);
+		return -1;
+	}
+
+	fclose(in);
+
+	if ((SimTaskCount == 0) || (SimEnd == 0))
+	{
+		fprintf(stderr, "%s: needs a task and ticks\n", file);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+///////////////////////////////////////////
+//Sim_Tick
+//One timer interrupt.  Ends the run with a
+//longjmp out of the scheduler at SimEnd.
+//
+static void Sim_Tick(void)
+{
+	if (SimTicks >= SimEnd)
+		longjmp(SimExit, 1);
+
+	Sim_TimerTick();
+	SimTicks++;
+}
+
+
+///////////////////////////////////////////
+//Sim_Run
+//A task run.  Task i times out every period
+//ticks from tick 0.  The timeouts since the
+//last run that are due by now are served by
+//this run, all but the first are coalesced.
+//The run is late if it ends at or after one
+//period past the first of them.
+//
+static void Sim_Run(uint8_t index)
+{
+	SimTask *task = &SimTasks[index];
+	uint32_t start = SimTicks;
+	uint32_t due = start / SIM_PERIOD(task);		//last timeout due by now
+	uint32_t first;
+	uint16_t i;
+
+	//ran without a timeout, can't happen
+	//without messages
+	if (due <= task->served)
+	{
+		printf("%6lu  %-12s ran with no timeout\n", (unsigned long)start, task->name);
+		SimErrors++;
+		return;
+	}
+
+	first = (task->served + 1) * SIM_PERIOD(task);
+
+	task->coalesced += due - task->served - 1;
+	task->served = due;
+	task->runs++;
+
+	if (start - first > task->latency)
+		task->latency = start - first;
+
+	if (SimVerbose)
+		printf("%6lu  %-12s late %lu\n", (unsigned long)start, task->name, (unsigned long)(start - first));
+
+	for (i = 0 ; i < task->cost ; i++)
+		Sim_Tick();
+
+	if (SimTicks >= first + SIM_PERIOD(task))
+		task->missed++;
+}
+
+
+///////////////////////////////////////////
+//Sim_Report
+//Print the stats, check them against the
+//tasker and the expects.  Returns 0 if all
+//good, 1 if not.
+//
+static int Sim_Report(void)
+{
+	SimExpect *expect;
+	SimTask *task;
+	uint32_t value;
+	uint32_t pending;
+	int errors = SimErrors;
+	int missed, coalesced;
+	int index;
+	int ok;
+	uint8_t i;
+
+	//the tasker's clock has to agree, with
+	//tickless that's the count plus TAR
+	if (Task_GetTickCount() != SimTicks)
+	{
+		printf("  tasker has %lu ticks\n", (unsigned long)Task_GetTickCount());
+		errors++;
+	}
+
+	printf("task          period  cost    runs  latency  missed  coalesced\n");
+
+	for (i = 0 ; i < SimTaskCount ; i++)
+	{
+		task = &SimTasks[i];
+		missed = Task_GetMissedDeadlines(i);
+		coalesced = Task_GetCoalescedPeriods(i);
+
+		printf("%-12s  %6u  %4u  %6lu  %7lu  %6lu  %9lu\n", task->name, task->period, task->cost,
+				(unsigned long)task->runs, (unsigned long)task->latency,
+				(unsigned long)task->missed, (unsigned long)task->coalesced);
+
+		//the tasker's counts stop at 0x7FFF
+		if ((task->missed < 0x7FFF) && ((uint32_t)missed != task->missed))
+		{
+			printf("  tasker has %d missed\n", missed);
+			errors++;
+		}
+
+		//timeouts still waiting at the end are only
+		//counted by the tasker, all but the first
+		pending = SimEnd / SIM_PERIOD(task) - task->served;
+		if (pending > 1)
+			pending--;
+		else
+			pending = 0;
+
+		if ((task->coalesced + pending < 0x7FFF) && ((uint32_t)coalesced != task->coalesced + pending))
+		{
+			printf("  tasker has %d coalesced\n", coalesced);
+			errors++;
+		}
+	}
+
+	for (i = 0 ; i < SimExpectCount ; i++)
+	{
+		expect = &SimExpects[i];
+
+		if (strcmp(expect->mode, "*") && strcmp(expect->mode, SIM_MODE))
+			continue;
+
+		index = Sim_Find(expect->name);
+		ok = 0;
+
+		if (index >= 0)
+			value = Sim_Stat(&SimTasks[index], expect->stat, &ok);
+
+		if (!ok)
+		{
+			printf("expect %s %s: no such task or stat\n", expect->name, expect->stat);
+			errors++;
+		}
+
+		else if (value > expect->max)
+		{
+			printf("expect %s %s <= %lu: %lu, FAIL\n", expect->name, expect->stat, (unsigned long)expect->max, (unsigned long)value);
+			errors++;
+		}
+
+		else
+			printf("expect %s %s <= %lu: %lu, ok\n", expect->name, expect->stat, (unsigned long)expect->max, (unsigned long)value);
+	}
+
+	printf("%s\n", errors ? "FAIL" : "PASS");
+
+	return errors ? 1 : 0;
+}
+
+
+static int Sim_Find(const char *name)
+{
+	uint8_t i;
+
+	for (i = 0 ; i < SimTaskCount ; i++)
+	{
+		if (!strcmp(SimTasks[i].name, name))
+			return i;
+	}
+
+	return -1;
+}
+
+
+static uint32_t Sim_Stat(const SimTask *task, const char *stat, int *ok)
+{
+	*ok = 1;
+
+	if (!strcmp(stat, "runs"))
+		return task->runs;
+	if (!strcmp(stat, "latency"))
+		return task->latency;
+	if (!strcmp(stat, "missed"))
+		return task->missed;
+	if (!strcmp(stat, "coalesced"))
+		return task->coalesced;
+
+	*ok = 0;
+	return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * test_profile.c
+ *
+ *  Checks the TASK_PROFILE stats on known task sets.
+ *  TA1R is a variable in sim.c, here it counts up
+ *  TEST_COUNTS every tick, so the run times and the
+ *  jitter come out in whole ticks of counts.  Time is
+ *  simulated like task_sim, a task that costs c ticks
+ *  ticks the timer c times while it runs.
+ *
+ *  First set: work (period 10, cost 3) ahead of poll
+ *  (period 0, cost 0).  poll times out on the tick work
+ *  does and waits the whole work run, so its jitter is
+ *  3 ticks once per work run and 0 otherwise.  Neither
+ *  overruns, a period 0 task that takes no time is on
+ *  time.
+ *
+ *  Second set: over (period 5, cost 5) ahead of tick
+ *  (period 0, cost 1).  Every run of both is an overrun.
+ *  Once over times out it's ready again every time it
+ *  finishes, so tick only gets the first 4 ticks.
+ *
+ *  The stats are read back with Task_ProfileDump() and
+ *  checked against the runs counted here.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include <msp430.h>
+
+#include "task.h"
+#include "sim.h"
+
+#define TEST_TICKS			1000UL
+#define TEST_COUNTS			2000U		//TA1R counts per tick, SMCLK 16mhz / 8
+
+typedef struct
+{
+	const char *name;
+	uint16_t period;
+	uint16_t cost;
+	uint32_t runs;			//runs that finished
+	TaskProfile profile;	//from Task_ProfileDump()
+
+}TestTask;
+
+static jmp_buf TestExit;
+static uint32_t TestTicks;
+static TestTask *TestSet;
+static uint8_t TestCount;
+static uint32_t TestErrors = 0;
+
+static TestTask TestFirst[] =
+{
+	{"work", 10, 3},
+	{"poll", 0, 0},
+};
+
+static TestTask TestSecond[] =
+{
+	{"over", 5, 5},
+	{"tick", 0, 1},
+};
+
+static void Test_Run(TestTask *set, uint8_t count);
+static void Test_Tick(void);
+static void Test_Task(uint8_t index);
+static void Test_Task0(void);
+static void Test_Task1(void);
+static void Test_Print(uint8_t index, const TaskProfile *profile);
+static void Test_Expect(const TestTask *task, const char *stat, uint32_t value, uint32_t expect);
+
+
+int main(void)
+{
+	const TestTask *work = &TestFirst[0];
+	const TestTask *poll = &TestFirst[1];
+	uint8_t i;
+
+	Test_Run(TestFirst, 2);
+
+	for (i = 0 ; i < 2 ; i++)
+	{
+		Test_Expect(&TestFirst[i], "runCount", TestFirst[i].profile.runCount, TestFirst[i].runs);
+		Test_Expect(&TestFirst[i], "runMin", TestFirst[i].profile.runMin, TestFirst[i].cost * TEST_COUNTS);
+		Test_Expect(&TestFirst[i], "runMax", TestFirst[i].profile.runMax, TestFirst[i].cost * TEST_COUNTS);
+		Test_Expect(&TestFirst[i], "runTotal", TestFirst[i].profile.runTotal,
+				TestFirst[i].runs * TestFirst[i].cost * TEST_COUNTS);
+		Test_Expect(&TestFirst[i], "overrun", TestFirst[i].profile.overrun, 0);
+	}
+
+	Test_Expect(work, "jitterMax", work->profile.jitterMax, 0);
+	Test_Expect(work, "jitterTotal", work->profile.jitterTotal, 0);
+	Test_Expect(poll, "jitterMax", poll->profile.jitterMax, work->cost * TEST_COUNTS);
+	Test_Expect(poll, "jitterTotal", poll->profile.jitterTotal, work->runs * work->cost * TEST_COUNTS);
+
+	Test_Run(TestSecond, 2);
+
+	for (i = 0 ; i < 2 ; i++)
+	{
+		Test_Expect(&TestSecond[i], "runCount", TestSecond[i].profile.runCount, TestSecond[i].runs);
+		Test_Expect(&TestSecond[i], "overrun", TestSecond[i].profile.overrun, TestSecond[i].runs);
+	}
+
+	//over is ready again the tick it finishes,
+	//tick only runs before over first times out
+	Test_Expect(&TestSecond[0], "jitterMax", TestSecond[0].profile.jitterMax, 0);
+	Test_Expect(&TestSecond[1], "runCount", TestSecond[1].profile.runCount, TestSecond[0].period - 1);
+
+	printf("test_profile: %lu errors: %s\n", (unsigned long)TestErrors, TestErrors ? "FAIL" : "PASS");
+
+	return TestErrors ? 1 : 0;
+}
+
+
+///////////////////////////////////////////
+//Test_Run
+//Run a set from tick 0 for TEST_TICKS and
+//read the stats back.
+//
+static void Test_Run(TestTask *set, uint8_t count)
+{
+	static void (* const functions[])(void) = {Test_Task0, Test_Task1};
+	uint8_t i;
+
+	TestSet = set;
+	TestCount = count;
+	TestTicks = 0;
+	TA1R = 0;
+
+	Task_Init();
+
+	for (i = 0 ; i < count ; i++)
+	{
+		set[i].runs = 0;
+		Task_AddTask(set[i].name, functions[i], set[i].period, i);
+	}
+
+	SimIdleHook = Test_Tick;
+
+	if (!setjmp(TestExit))
+		Task_StartScheduler();
+
+	Task_ProfileDump(Test_Print);
+
+	printf("task    period  cost    runs  runMin  runMax  jitterMax  jitterTotal  overrun\n");
+
+	for (i = 0 ; i < count ; i++)
+	{
+		printf("%-6s  %6u  %4u  %6lu  %6u  %6u  %9u  %11lu  %7u\n", set[i].name, set[i].period,
+				set[i].cost, (unsigned long)set[i].profile.runCount, set[i].profile.runMin,
+				set[i].profile.runMax, set[i].profile.jitterMax,
+				(unsigned long)set[i].profile.jitterTotal, set[i].profile.overrun);
+	}
+}
+
+
+///////////////////////////////////////////
+//Test_Tick
+//One timer interrupt, TA1R runs on a tick
+//first.  Ends the run at TEST_TICKS.
+//
+static void Test_Tick(void)
+{
+	if (TestTicks >= TEST_TICKS)
+		longjmp(TestExit, 1);
+
+	TA1R += TEST_COUNTS;
+	Sim_TimerTick();
+	TestTicks++;
+}
+
+
+///////////////////////////////////////////
+//Test_Task
+//A run that takes cost ticks.  Only counted
+//when it finishes, a run cut off at the end
+//doesn't get into the stats either.
+//
+static void Test_Task(uint8_t index)
+{
+	uint16_t i;
+
+	for (i = 0 ; i < TestSet[index].cost ; i++)
+		Test_Tick();
+
+	TestSet[index].runs++;
+}
+
+static void Test_Task0(void)
+{
+	Test_Task(0);
+}
+
+static void Test_Task1(void)
+{
+	Test_Task(1);
+}
+
+
+static void Test_Print(uint8_t index, const TaskProfile *profile)
+{
+	if (index < TestCount)
+		TestSet[index].profile = *profile;
+}
+
+
+static void Test_Expect(const TestTask *task, const char *stat, uint32_t value, uint32_t expect)
+{
+	if (value == expect)
+		return;
+
+	printf("  %s %s is %lu, expected %lu\n", task->name, stat, (unsigned long)value, (unsigned long)expect);
+	TestErrors++;
+}
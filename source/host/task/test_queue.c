@@ -0,0 +1,159 @@
+/*
+ * test_queue.c
+ *
+ *  Stress test for the task message queues.  A second
+ *  thread plays the isr and posts TEST_MESSAGES numbered
+ *  messages to one task as fast as it can.  The main
+ *  thread plays the task and reads them back.  On more
+ *  than one core the two run at the same time, which is
+ *  harder on the queue than a real isr.  On one core the
+ *  kernel can switch between them at any instruction,
+ *  like an isr.
+ *
+ *  A post to a full queue is dropped, the poster marks
+ *  it in TestDropped[].  The reader checks that every
+ *  message comes out once, in order, and that the only
+ *  numbers missing are the ones marked dropped.  The
+ *  sequence number is 24 bits, the top 8 in the signal
+ *  and the low 16 in the value.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "task.h"
+#include "sim.h"
+
+#define TEST_MESSAGES		2000000UL
+#define TEST_TASK			0
+
+static volatile uint8_t TestDropped[TEST_MESSAGES];
+static volatile uint32_t TestDropCount = 0;
+static volatile uint8_t TestDone = 0;
+
+static void Test_Nop(void);
+static void* Test_Isr(void *arg);
+
+
+int main(void)
+{
+	pthread_t isr;
+	TaskMessage msg;
+	uint32_t expected = 0;
+	uint32_t received = 0;
+	uint32_t errors = 0;
+	uint32_t seq;
+	uint64_t start;
+	double ms;
+	uint8_t done;
+
+	Task_Init();
+	Task_AddTask("rx", Test_Nop, 1000, TEST_TASK);
+	Task_AttachMessageQueue(TEST_TASK);
+
+	start = Sim_Now();
+	pthread_create(&isr, NULL, Test_Isr, NULL);
+
+	do
+	{
+		//read done before the queue, so nothing is
+		//left behind when it's seen set
+		done = TestDone;
+
+		if (Task_GetNumMessageWaiting(TEST_TASK) == 0)
+			sched_yield();
+
+		while (Task_GetNextMessage(TEST_TASK, &msg) > 0)
+		{
+			seq = ((uint32_t)msg.signal << 16) | msg.value;
+
+			//everything skipped has to have been dropped
+			if (seq < expected)
+			{
+				errors++;
+				continue;
+			}
+
+			while (expected < seq)
+			{
+				if (!TestDropped[expected])
+					errors++;
+				expected++;
+			}
+
+			if (TestDropped[seq])
+				errors++;
+
+			expected = seq + 1;
+			received++;
+		}
+
+	} while (!done);
+
+	pthread_join(isr, NULL);
+	ms = (double)(Sim_Now() - start) / 1000000.0;
+
+	//the tail end can be drops too
+	while (expected < TEST_MESSAGES)
+	{
+		if (!TestDropped[expected])
+			errors++;
+		expected++;
+	}
+
+	if (received + TestDropCount != TEST_MESSAGES)
+		errors++;
+
+	if (Task_GetMessageOverflow(TEST_TASK) != (TestDropCount < 0xFF ? (int)TestDropCount : 0xFF))
+		errors++;
+
+	printf("test_queue: %lu posted, %lu dropped, %lu received in %.0f ms, %lu errors: %s\n",
+			TEST_MESSAGES, (unsigned long)TestDropCount, (unsigned long)received, ms,
+			(unsigned long)errors, errors ? "FAIL" : "PASS");
+
+	return errors ? 1 : 0;
+}
+
+
+static void Test_Nop(void)
+{
+}
+
+
+///////////////////////////////////////////
+//Test_Isr
+//The posting side.  Marks a drop before
+//posting the next message, so the reader
+//sees the mark by the time it gets there.
+//After a drop it gives up the cpu, so on a
+//single core the reader gets to run before
+//the queue has been full for the rest of
+//the time slice.
+//
+static void* Test_Isr(void *arg)
+{
+	TaskMessage msg;
+	uint32_t seq;
+
+	(void)arg;
+
+	for (seq = 0 ; seq < TEST_MESSAGES ; seq++)
+	{
+		msg.signal = (uint8_t)(seq >> 16);
+		msg.value = (uint16_t)seq;
+
+		if (Task_SendMessage(TEST_TASK, msg) < 0)
+		{
+			TestDropped[seq] = 1;
+			TestDropCount++;
+			sched_yield();
+		}
+	}
+
+	TestDone = 1;
+
+	return NULL;
+}